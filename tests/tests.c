@@ -1,15 +1,27 @@
 #include "unity.h"
 
+#include "command.h"
 #include "data.h"
+#include "game.h"
+#include "grid.h"
+#include "hud.h"
 #include "io.h"
 #include "logger.h"
 #include "numeric.h"
+#include "physics.h"
+#include "platform.h"
+#include "player.h"
+#include "profiler.h"
 #include "random.h"
+#include "render.h"
 #include "rest.h"
+#include "snapshot.h"
 #include "sort.h"
+#include "terminal.h"
 #include "text.h"
 
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -24,6 +36,9 @@
 #define WRAP_TEST_WIDTH_40 "assets/tests/wrap-test-width-40.txt"
 #define WRAP_TEST_WIDTH_80 "assets/tests/wrap-test-width-80.txt"
 
+/* How many Platforms the throughput of update_platforms is measured with. */
+#define MANY_PLATFORMS 4096
+
 int compare_unsigned_char(const void *pointer_a, const void *pointer_b) {
   unsigned char a = *(unsigned char *)(pointer_a);
   unsigned char b = *(unsigned char *)(pointer_b);
@@ -38,6 +53,13 @@ void test_normalize(void) {
   TEST_ASSERT_EQUAL_INT(1, normalize(INT_MAX));
 }
 
+void test_find_first_set(void) {
+  TEST_ASSERT_EQUAL_INT(-1, find_first_set(0));
+  TEST_ASSERT_EQUAL_INT(0, find_first_set(1));
+  TEST_ASSERT_EQUAL_INT(3, find_first_set(24));
+  TEST_ASSERT_EQUAL_INT(63, find_first_set((uint64_t)1 << 63));
+}
+
 void test_get_random_perk_is_well_distributed(void) {
   const int maximum_allowed_deviation = 1 << 10;
   const int average = 1 << 16;
@@ -341,10 +363,457 @@ void test_random_integer_is_evenly_distributed(void) {
   }
 }
 
+void test_write_string_to_grid_writes_glyphs_and_colors(void) {
+  static Grid grid;
+  clear_grid(&grid, DEFAULT_COLOR);
+  write_string_to_grid(&grid, 1, 2, "ab", PLATFORM_COLOR);
+  TEST_ASSERT_EQUAL_INT(' ', grid.cells[2][0].glyph);
+  TEST_ASSERT_EQUAL_INT('a', grid.cells[2][1].glyph);
+  TEST_ASSERT_EQUAL_INT('b', grid.cells[2][2].glyph);
+  TEST_ASSERT_EQUAL_INT(' ', grid.cells[2][3].glyph);
+  TEST_ASSERT_TRUE(
+      color_pair_equals(PLATFORM_COLOR, grid.cells[2][2].color_pair));
+  TEST_ASSERT_TRUE(
+      color_pair_equals(DEFAULT_COLOR, grid.cells[2][3].color_pair));
+}
+
+void test_write_string_to_grid_discards_characters_outside_of_the_grid(void) {
+  static Grid grid;
+  static Grid expected;
+  clear_grid(&grid, DEFAULT_COLOR);
+  clear_grid(&expected, DEFAULT_COLOR);
+  expected.cells[0][0].glyph = 'c';
+  expected.cells[0][COLUMNS - 1].glyph = 'a';
+  write_string_to_grid(&grid, -2, 0, "abc", DEFAULT_COLOR);
+  write_string_to_grid(&grid, COLUMNS - 1, 0, "abc", DEFAULT_COLOR);
+  write_string_to_grid(&grid, 0, -1, "abc", DEFAULT_COLOR);
+  write_string_to_grid(&grid, 0, LINES, "abc", DEFAULT_COLOR);
+  TEST_ASSERT_EQUAL_MEMORY(&expected, &grid, sizeof(Grid));
+}
+
+void test_update_hud_only_rebuilds_bars_after_changes(void) {
+  static Grid layer;
+  static Hud hud;
+  Player player = make_player("Name");
+  clear_grid(&layer, DEFAULT_COLOR);
+  invalidate_hud(&hud);
+  TEST_ASSERT_TRUE(update_hud(&hud, &player, "", &layer));
+  TEST_ASSERT_FALSE(update_hud(&hud, &player, "", &layer));
+  player.score++;
+  TEST_ASSERT_TRUE(update_hud(&hud, &player, "", &layer));
+  TEST_ASSERT_FALSE(update_hud(&hud, &player, "", &layer));
+  TEST_ASSERT_TRUE(update_hud(&hud, &player, "Got Time Stop!", &layer));
+  TEST_ASSERT_EQUAL_INT('G', hud.bottom_bar[0].glyph);
+  TEST_ASSERT_FALSE(update_hud(&hud, &player, "Got Time Stop!", &layer));
+}
+
+/**
+ * Writes the sequence which sets the provided ColorPair on the terminal.
+ */
+static size_t write_terminal_colors(char *output, const ColorPair colors) {
+  return sprintf(output, "\033[38;2;%d;%d;%d;48;2;%d;%d;%dm",
+                 colors.foreground.r, colors.foreground.g, colors.foreground.b,
+                 colors.background.r, colors.background.g,
+                 colors.background.b);
+}
+
+void test_encode_grid_changes_only_writes_changed_cells(void) {
+  static Grid grid;
+  static char output[TERMINAL_OUTPUT_SIZE];
+  char expected[MAXIMUM_STRING_SIZE];
+  size_t size;
+  clear_grid(&grid, DEFAULT_COLOR);
+  invalidate_terminal_grid();
+  TEST_ASSERT_TRUE(encode_grid_changes(&grid, output) >= LINES * COLUMNS);
+  TEST_ASSERT_EQUAL_INT(0, encode_grid_changes(&grid, output));
+  grid.cells[2][5].glyph = 'a';
+  size = sprintf(expected, "\033[3;6H");
+  size += write_terminal_colors(expected + size, DEFAULT_COLOR);
+  expected[size++] = 'a';
+  TEST_ASSERT_EQUAL_INT(size, encode_grid_changes(&grid, output));
+  TEST_ASSERT_EQUAL_MEMORY(expected, output, size);
+  TEST_ASSERT_EQUAL_INT(0, encode_grid_changes(&grid, output));
+}
+
+void test_encode_grid_changes_coalesces_nearby_changes(void) {
+  static Grid grid;
+  static char output[TERMINAL_OUTPUT_SIZE];
+  char expected[MAXIMUM_STRING_SIZE];
+  size_t size;
+  clear_grid(&grid, DEFAULT_COLOR);
+  invalidate_terminal_grid();
+  encode_grid_changes(&grid, output);
+  /* A short gap of the same colors is rewritten, a long one is skipped, and
+   * another row is moved to, all with a single color change. */
+  write_string_to_grid(&grid, 5, 2, "a", DEFAULT_COLOR);
+  write_string_to_grid(&grid, 8, 2, "b", DEFAULT_COLOR);
+  write_string_to_grid(&grid, 20, 2, "c", DEFAULT_COLOR);
+  write_string_to_grid(&grid, 0, 4, "d", DEFAULT_COLOR);
+  size = sprintf(expected, "\033[3;6H");
+  size += write_terminal_colors(expected + size, DEFAULT_COLOR);
+  size += sprintf(expected + size, "a  b\033[11Cc\033[5;1Hd");
+  TEST_ASSERT_EQUAL_INT(size, encode_grid_changes(&grid, output));
+  TEST_ASSERT_EQUAL_MEMORY(expected, output, size);
+  /* Changing colors is written once for each run of Cells. */
+  write_string_to_grid(&grid, 0, 6, "ef", PLATFORM_COLOR);
+  size = sprintf(expected, "\033[7;1H");
+  size += write_terminal_colors(expected + size, PLATFORM_COLOR);
+  size += sprintf(expected + size, "ef");
+  TEST_ASSERT_EQUAL_INT(size, encode_grid_changes(&grid, output));
+  TEST_ASSERT_EQUAL_MEMORY(expected, output, size);
+}
+
+void test_sort_and_merge_render_commands_merges_adjacent_fills(void) {
+  static RenderCommandBuffer buffer;
+  clear_render_commands(&buffer);
+  append_fill_command(&buffer, 2, 1, 1, PLATFORM_COLOR);
+  append_glyph_command(&buffer, 0, 1, 1, DEFAULT_COLOR);
+  append_fill_command(&buffer, 1, 1, 1, PLATFORM_COLOR);
+  append_fill_command(&buffer, 3, 1, 1, TOP_BAR_COLOR);
+  append_fill_command(&buffer, 3, 2, 1, PLATFORM_COLOR);
+  sort_and_merge_render_commands(&buffer);
+  TEST_ASSERT_EQUAL_INT(4, buffer.count);
+  /* Fills come first, grouped by color, with adjacent fills merged. */
+  TEST_ASSERT_EQUAL_INT(RENDER_COMMAND_FILL, buffer.commands[0].kind);
+  TEST_ASSERT_EQUAL_INT(RENDER_COMMAND_FILL, buffer.commands[1].kind);
+  TEST_ASSERT_EQUAL_INT(RENDER_COMMAND_FILL, buffer.commands[2].kind);
+  TEST_ASSERT_EQUAL_INT(RENDER_COMMAND_GLYPH, buffer.commands[3].kind);
+  TEST_ASSERT_EQUAL_INT(1, buffer.commands[0].x);
+  TEST_ASSERT_EQUAL_INT(2, buffer.commands[0].w);
+  TEST_ASSERT_EQUAL_INT(3, buffer.commands[1].x);
+  TEST_ASSERT_EQUAL_INT(2, buffer.commands[1].y);
+  TEST_ASSERT_TRUE(
+      color_pair_equals(TOP_BAR_COLOR, buffer.commands[2].color_pair));
+}
+
+void test_interpolate_coordinate_does_not_interpolate_repositions(void) {
+  TEST_ASSERT_EQUAL_FLOAT(4.0, interpolate_coordinate(4, 5, 0.0));
+  TEST_ASSERT_EQUAL_FLOAT(4.25, interpolate_coordinate(4, 5, 0.25));
+  TEST_ASSERT_EQUAL_FLOAT(4.5, interpolate_coordinate(5, 4, 0.5));
+  TEST_ASSERT_EQUAL_FLOAT(1.0, interpolate_coordinate(78, 1, 0.5));
+}
+
+void test_snapshot_exchange_returns_the_latest_published_state(void) {
+  static SnapshotExchange exchange;
+  initialize_snapshot_exchange(&exchange);
+  get_back_state(&exchange)->deadline = 1;
+  publish_back_state(&exchange);
+  get_back_state(&exchange)->deadline = 2;
+  publish_back_state(&exchange);
+  TEST_ASSERT_EQUAL_INT(2, get_latest_state(&exchange)->deadline);
+  /* Without a new state, the reader keeps the one it has. */
+  TEST_ASSERT_EQUAL_INT(2, get_latest_state(&exchange)->deadline);
+  get_back_state(&exchange)->deadline = 3;
+  publish_back_state(&exchange);
+  TEST_ASSERT_EQUAL_INT(3, get_latest_state(&exchange)->deadline);
+}
+
+void test_get_histogram_bucket_doubles_bucket_widths(void) {
+  TEST_ASSERT_EQUAL_INT(0, get_histogram_bucket(0));
+  TEST_ASSERT_EQUAL_INT(1, get_histogram_bucket(1));
+  TEST_ASSERT_EQUAL_INT(2, get_histogram_bucket(2));
+  TEST_ASSERT_EQUAL_INT(2, get_histogram_bucket(3));
+  TEST_ASSERT_EQUAL_INT(6, get_histogram_bucket(33));
+  TEST_ASSERT_EQUAL_INT(10, get_histogram_bucket(512));
+  TEST_ASSERT_EQUAL_INT(HISTOGRAM_BUCKET_COUNT - 1,
+                        get_histogram_bucket(32768));
+  TEST_ASSERT_EQUAL_INT(HISTOGRAM_BUCKET_COUNT - 1, get_histogram_bucket(-1));
+}
+
+void test_adapt_spin_threshold_clamps_and_decays(void) {
+  int previous;
+  int i;
+  /* Oversleeping beyond the maximum is clamped to it, at once. */
+  adapt_spin_threshold(MAXIMUM_SPIN_THRESHOLD * 10);
+  TEST_ASSERT_EQUAL_INT(MAXIMUM_SPIN_THRESHOLD, get_spin_threshold());
+  /* Precise sleeping makes the threshold fall slowly, but never below the
+   * minimum. */
+  previous = get_spin_threshold();
+  adapt_spin_threshold(0);
+  TEST_ASSERT_TRUE(get_spin_threshold() < previous);
+  TEST_ASSERT_TRUE(get_spin_threshold() > previous / 2);
+  for (i = 0; i < 1000; i++) {
+    previous = get_spin_threshold();
+    adapt_spin_threshold(0);
+    TEST_ASSERT_TRUE(get_spin_threshold() <= previous);
+    TEST_ASSERT_TRUE(get_spin_threshold() >= MINIMUM_SPIN_THRESHOLD);
+  }
+  TEST_ASSERT_TRUE(get_spin_threshold() < MAXIMUM_SPIN_THRESHOLD / 2);
+}
+
+void test_command_queue_keeps_order_and_counts_drops(void) {
+  static CommandQueue queue;
+  TimedCommand command;
+  int i;
+  initialize_command_queue(&queue);
+  for (i = 0; i < COMMAND_QUEUE_SIZE; i++) {
+    command.command = i % 2 ? COMMAND_LEFT : COMMAND_RIGHT;
+    command.timestamp = i;
+    TEST_ASSERT_EQUAL_INT(CODE_OK, push_command(&queue, command));
+  }
+  TEST_ASSERT_EQUAL_INT(CODE_ERROR, push_command(&queue, command));
+  TEST_ASSERT_EQUAL_INT(1, get_dropped_command_count(&queue));
+  for (i = 0; i < COMMAND_QUEUE_SIZE; i++) {
+    TEST_ASSERT_TRUE(pop_command(&queue, &command));
+    TEST_ASSERT_EQUAL_INT(i % 2 ? COMMAND_LEFT : COMMAND_RIGHT,
+                          command.command);
+    TEST_ASSERT_EQUAL_INT(i, command.timestamp);
+  }
+  TEST_ASSERT_FALSE(pop_command(&queue, &command));
+  /* The indices wrap around after the queue has been emptied. */
+  TEST_ASSERT_EQUAL_INT(CODE_OK, push_command(&queue, command));
+  TEST_ASSERT_TRUE(pop_command(&queue, &command));
+}
+
+void test_should_move_at_current_frame_scales_with_the_tick_rate(void) {
+  Game game;
+  int moves;
+  game.tick_rate = 60;
+  moves = 0;
+  for (game.frame = 1; game.frame <= 60; game.frame++) {
+    moves += should_move_at_current_frame(&game, 4);
+  }
+  TEST_ASSERT_EQUAL_INT(4, moves);
+  game.tick_rate = 120;
+  moves = 0;
+  for (game.frame = 1; game.frame <= 120; game.frame++) {
+    moves += should_move_at_current_frame(&game, 4);
+  }
+  TEST_ASSERT_EQUAL_INT(4, moves);
+  /* Objects faster than the tick rate move at every frame. */
+  game.tick_rate = 5;
+  game.frame = 1;
+  TEST_ASSERT_TRUE(should_move_at_current_frame(&game, 12));
+}
+
+void test_movement_schedule_matches_frame_division(void) {
+  const int tick_rates[] = {5, 30, 60, 144};
+  Game game;
+  int expected;
+  int speed;
+  size_t i;
+  for (i = 0; i < sizeof(tick_rates) / sizeof(tick_rates[0]); i++) {
+    game.frame = 0;
+    game.tick_rate = tick_rates[i];
+    initialize_movement_schedule(&game);
+    while (game.frame < 1000) {
+      advance_frame(&game);
+      TEST_ASSERT_EQUAL_INT(game.frame, game.schedule.frame);
+      for (speed = -MAXIMUM_SCHEDULED_SPEED - 4;
+           speed <= MAXIMUM_SCHEDULED_SPEED + 4; speed++) {
+        expected = 0;
+        if (speed != 0) {
+          expected = (unsigned long)(game.tick_rate / (double)abs(speed) + 0.5);
+          expected = expected == 0 || game.frame % expected == 0;
+        }
+        TEST_ASSERT_EQUAL_INT(expected,
+                              should_move_at_current_frame(&game, speed));
+      }
+    }
+  }
+}
+
+void test_find_platform_at_matches_a_linear_scan(void) {
+  char name[] = "Test";
+  Player player = make_player(name);
+  Platform platforms[PLATFORM_COUNT];
+  BoundingBox box = bounding_box_from_screen();
+  Game game;
+  int expected;
+  int frame;
+  int x;
+  int y;
+  size_t i;
+  player.x = COLUMNS / 2;
+  player.y = LINES / 2;
+  generate_platforms(platforms, PLATFORM_COUNT);
+  game = create_game(&player, platforms, PLATFORM_COUNT, &box, FPS);
+  for (frame = 0; frame < 10 * FPS; frame++) {
+    update_platforms(&game);
+    advance_frame(&game);
+    for (y = 0; y < LINES; y++) {
+      for (x = 0; x < COLUMNS; x++) {
+        expected = 0;
+        for (i = 0; i < PLATFORM_COUNT; i++) {
+          if (game.platforms.y[i] == y && x >= game.platforms.x[i] &&
+              x < game.platforms.x[i] + game.platforms.width[i]) {
+            expected = 1;
+          }
+        }
+        TEST_ASSERT_EQUAL_INT(expected,
+                              find_platform_at(&game, x, y) != -1);
+      }
+    }
+  }
+  destroy_game(&game);
+}
+
+void test_free_lines_match_the_platforms_on_each_line(void) {
+  char name[] = "Test";
+  Player player = make_player(name);
+  Platform platforms[PLATFORM_COUNT];
+  BoundingBox box = bounding_box_from_screen();
+  Game game;
+  int is_free;
+  int frame;
+  int y;
+  size_t i;
+  player.x = COLUMNS / 2;
+  player.y = LINES / 2;
+  generate_platforms(platforms, PLATFORM_COUNT);
+  game = create_game(&player, platforms, PLATFORM_COUNT, &box, FPS);
+  for (frame = 0; frame < 10 * FPS; frame++) {
+    update_platforms(&game);
+    advance_frame(&game);
+    for (y = 0; y < LINES; y++) {
+      is_free = 1;
+      for (i = 0; i < PLATFORM_COUNT; i++) {
+        /* Platforms off the screen are on the first or the last line. */
+        if (max(0, min(game.platforms.y[i], LINES - 1)) == y) {
+          is_free = 0;
+        }
+      }
+      TEST_ASSERT_EQUAL_INT(is_free, (game.free_lines >> y) & 1);
+    }
+  }
+  destroy_game(&game);
+}
+
+void test_find_free_row_probes_the_rows_of_the_box(void) {
+  char name[] = "Test";
+  Player player = make_player(name);
+  Platform platforms[5];
+  BoundingBox box;
+  Game game;
+  size_t i;
+  /* The box has five rows, and the lines around it are free. */
+  box.min_x = 1;
+  box.max_x = COLUMNS - 2;
+  box.min_y = 2;
+  box.max_y = 6;
+  for (i = 0; i < 5; i++) {
+    platforms[i].x = 4;
+    platforms[i].y = box.min_y + i;
+    platforms[i].speed_x = 0;
+    platforms[i].speed_y = 0;
+    platforms[i].width = 4;
+  }
+  /* Take rows 0, 2 and 4. */
+  platforms[1].y = box.min_y;
+  platforms[3].y = box.min_y + 2;
+  game = create_game(&player, platforms, 5, &box, FPS);
+  TEST_ASSERT_EQUAL_INT(1, find_free_row(&game, 0));
+  TEST_ASSERT_EQUAL_INT(1, find_free_row(&game, 1));
+  TEST_ASSERT_EQUAL_INT(3, find_free_row(&game, 2));
+  /* The free line under the box is not a row, so the probe wraps around. */
+  TEST_ASSERT_EQUAL_INT(1, find_free_row(&game, 4));
+  destroy_game(&game);
+  /* Take every row. */
+  platforms[1].y = box.min_y + 1;
+  platforms[3].y = box.min_y + 3;
+  game = create_game(&player, platforms, 5, &box, FPS);
+  for (i = 0; i < 5; i++) {
+    TEST_ASSERT_EQUAL_INT(i, find_free_row(&game, i));
+  }
+  destroy_game(&game);
+}
+
+void test_occupancy_matches_the_scalar_functions(void) {
+  char name[] = "Test";
+  Player player = make_player(name);
+  Platform platforms[PLATFORM_COUNT];
+  BoundingBox box = bounding_box_from_screen();
+  Game game;
+  int expected;
+  int frame;
+  int x;
+  int y;
+  int width;
+  size_t i;
+  player.x = COLUMNS / 2;
+  player.y = LINES / 2;
+  generate_platforms(platforms, PLATFORM_COUNT);
+  game = create_game(&player, platforms, PLATFORM_COUNT, &box, FPS);
+  for (frame = 0; frame < 10 * FPS; frame++) {
+    update_platforms(&game);
+    advance_frame(&game);
+    for (y = -1; y <= LINES; y++) {
+      for (x = -16; x < COLUMNS + 16; x++) {
+        TEST_ASSERT_EQUAL_INT(find_platform_at(&game, x, y) != -1,
+                              is_cell_occupied(&game, x, y));
+      }
+    }
+    for (y = 0; y < LINES; y++) {
+      for (x = 0; x < COLUMNS; x += 7) {
+        width = 1 + (x + y + frame) % 20;
+        /* Only the cells on the screen are tested. */
+        if (x + width > COLUMNS) {
+          continue;
+        }
+        expected = 0;
+        for (i = 0; i < PLATFORM_COUNT; i++) {
+          if (game.platforms.y[i] == y && game.platforms.x[i] < x + width &&
+              game.platforms.x[i] + game.platforms.width[i] > x) {
+            expected = 1;
+          }
+        }
+        TEST_ASSERT_EQUAL_INT(expected, is_span_occupied(&game, x, y, width));
+      }
+    }
+  }
+  destroy_game(&game);
+}
+
+/**
+ * Updates a Game with the provided number of Platforms for a few seconds,
+ * checking that every Platform moved by its step.
+ *
+ * How long this takes is measured by --benchmark with --platforms=N instead.
+ */
+static void update_many_platforms(const size_t count) {
+  const int frame_count = 4 * FPS;
+  char name[] = "Test";
+  Player player = make_player(name);
+  static Platform platforms[MANY_PLATFORMS];
+  static int previous_x[MANY_PLATFORMS];
+  BoundingBox box = bounding_box_from_screen();
+  Game game;
+  int step;
+  int frame;
+  size_t i;
+  player.x = COLUMNS / 2;
+  player.y = LINES / 2;
+  generate_platforms(platforms, count);
+  game = create_game(&player, platforms, count, &box, FPS);
+  for (frame = 0; frame < frame_count; frame++) {
+    memcpy(previous_x, game.platforms.x, count * sizeof(int));
+    update_platforms(&game);
+    for (i = 0; i < count; i++) {
+      step = 0;
+      if (should_move_at_current_frame(&game, game.platforms.speed_x[i])) {
+        step = normalize(game.platforms.speed_x[i]);
+      }
+      /* Platforms which left the box were repositioned instead. */
+      if (previous_x[i] + step + game.platforms.width[i] >= box.min_x &&
+          previous_x[i] + step <= box.max_x) {
+        TEST_ASSERT_EQUAL_INT(previous_x[i] + step, game.platforms.x[i]);
+      }
+    }
+    advance_frame(&game);
+  }
+  destroy_game(&game);
+}
+
+void test_update_platforms_moves_thousands_of_platforms(void) {
+  update_many_platforms(MANY_PLATFORMS / 4);
+  update_many_platforms(MANY_PLATFORMS);
+}
+
 int main(void) {
   UNITY_BEGIN();
   log_message("Started running tests");
   RUN_TEST(test_normalize);
+  RUN_TEST(test_find_first_set);
   RUN_TEST(test_get_random_perk_is_well_distributed);
   RUN_TEST(test_trim_string_works_with_empty_strings);
   RUN_TEST(test_trim_string_works_with_already_trimmed_strings);
@@ -370,6 +839,24 @@ int main(void) {
   RUN_TEST(test_find_next_power_of_two_works_for_positive_integers);
   RUN_TEST(test_random_integer_respects_the_provided_range);
   RUN_TEST(test_random_integer_is_evenly_distributed);
+  RUN_TEST(test_write_string_to_grid_writes_glyphs_and_colors);
+  RUN_TEST(test_write_string_to_grid_discards_characters_outside_of_the_grid);
+  RUN_TEST(test_update_hud_only_rebuilds_bars_after_changes);
+  RUN_TEST(test_encode_grid_changes_only_writes_changed_cells);
+  RUN_TEST(test_encode_grid_changes_coalesces_nearby_changes);
+  RUN_TEST(test_sort_and_merge_render_commands_merges_adjacent_fills);
+  RUN_TEST(test_interpolate_coordinate_does_not_interpolate_repositions);
+  RUN_TEST(test_snapshot_exchange_returns_the_latest_published_state);
+  RUN_TEST(test_get_histogram_bucket_doubles_bucket_widths);
+  RUN_TEST(test_adapt_spin_threshold_clamps_and_decays);
+  RUN_TEST(test_command_queue_keeps_order_and_counts_drops);
+  RUN_TEST(test_should_move_at_current_frame_scales_with_the_tick_rate);
+  RUN_TEST(test_movement_schedule_matches_frame_division);
+  RUN_TEST(test_find_platform_at_matches_a_linear_scan);
+  RUN_TEST(test_free_lines_match_the_platforms_on_each_line);
+  RUN_TEST(test_find_free_row_probes_the_rows_of_the_box);
+  RUN_TEST(test_occupancy_matches_the_scalar_functions);
+  RUN_TEST(test_update_platforms_moves_thousands_of_platforms);
   log_message("Finished running tests");
   return UNITY_END();
 }
@@ -13,14 +13,17 @@
 Code info(SDL_Renderer *renderer) {
   char buffer[ABOUT_PAGE_BUFFER_SIZE];
   int error = read_characters(ABOUT_PAGE_PATH, buffer, ABOUT_PAGE_BUFFER_SIZE);
+  Code code = CODE_REDRAW;
   if (error) {
     log_message("Failed to read the text");
     return CODE_ERROR;
-  } else {
+  }
+  /*
+   * The code for this function is the code of waiting for input.
+   */
+  while (code == CODE_REDRAW) {
     print_long_text(buffer, renderer);
-    /*
-     * The code for this function is the code of waiting for input.
-     */
-    return wait_for_input();
+    code = wait_for_input();
   }
+  return code;
 }
@@ -0,0 +1,246 @@
+#include "capture.h"
+
+#include "clock.h"
+#include "code.h"
+#include "constants.h"
+#include "logger.h"
+#include "memory.h"
+#include "profiler.h"
+
+#include <SDL.h>
+
+#include <stdio.h>
+
+#define BYTES_PER_PIXEL 4
+
+/**
+ * The offset of the chroma planes, scaled by the 8 bits the sums are shifted
+ * by. Adding it before shifting keeps the sums nonnegative.
+ */
+#define CHROMA_OFFSET (128 << 8)
+
+/**
+ * The capture buffers form a ring. The game thread fills them in order and
+ * the writer thread empties them in the same order, so only the number of
+ * filled buffers needs to be shared.
+ */
+static Uint32 *buffers[CAPTURE_BUFFER_COUNT];
+static size_t fill_index = 0;
+static size_t write_index = 0;
+static size_t filled_count = 0;
+/* Set by finalize_capture, or by the writer if writing to the file failed. */
+static int is_stopping = 0;
+
+static SDL_mutex *mutex = NULL;
+static SDL_cond *condition = NULL;
+static SDL_Thread *writer = NULL;
+
+static FILE *file = NULL;
+static int frame_width = 0;
+static int frame_height = 0;
+/**
+ * The planes of the frame the writer is converting, only used by the writer.
+ */
+static unsigned char *planes = NULL;
+static unsigned long captured_frames = 0;
+static unsigned long dropped_frames = 0;
+
+/**
+ * Converts an ARGB8888 frame to the three full-resolution planes of a Y4M
+ * C444 frame, using the BT.601 studio swing coefficients.
+ */
+static void convert_frame(const Uint32 *pixels, unsigned char *planes,
+                          const size_t pixel_count) {
+  unsigned char *y_plane = planes;
+  unsigned char *u_plane = planes + pixel_count;
+  unsigned char *v_plane = planes + 2 * pixel_count;
+  int r;
+  int g;
+  int b;
+  size_t i;
+  for (i = 0; i < pixel_count; i++) {
+    r = (pixels[i] >> 16) & 0xFF;
+    g = (pixels[i] >> 8) & 0xFF;
+    b = pixels[i] & 0xFF;
+    y_plane[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+    u_plane[i] = (-38 * r - 74 * g + 112 * b + 128 + CHROMA_OFFSET) >> 8;
+    v_plane[i] = (112 * r - 94 * g - 18 * b + 128 + CHROMA_OFFSET) >> 8;
+  }
+}
+
+/**
+ * Writes the filled buffers to the file until the capture stops and every
+ * buffer has been written.
+ *
+ * If writing fails, the capture is stopped and the remaining buffers are
+ * discarded.
+ */
+static int write_frames(void *data) {
+  const size_t pixel_count = frame_width * frame_height;
+  int should_write;
+  int has_failed;
+  (void)data;
+  while (1) {
+    SDL_LockMutex(mutex);
+    while (filled_count == 0 && !is_stopping) {
+      SDL_CondWait(condition, mutex);
+    }
+    should_write = filled_count > 0;
+    SDL_UnlockMutex(mutex);
+    if (!should_write) {
+      return 0;
+    }
+    /* The game thread does not touch filled buffers, so no lock is held. */
+    convert_frame(buffers[write_index], planes, pixel_count);
+    has_failed = fputs("FRAME\n", file) == EOF ||
+                 fwrite(planes, 1, 3 * pixel_count, file) != 3 * pixel_count;
+    write_index = (write_index + 1) % CAPTURE_BUFFER_COUNT;
+    SDL_LockMutex(mutex);
+    filled_count--;
+    if (has_failed) {
+      is_stopping = 1;
+      filled_count = 0;
+    }
+    SDL_UnlockMutex(mutex);
+    if (has_failed) {
+      log_message("Stopped capturing after failing to write a frame");
+      return 0;
+    }
+  }
+}
+
+static void free_buffers(void) {
+  size_t i;
+  for (i = 0; i < CAPTURE_BUFFER_COUNT; i++) {
+    buffers[i] = resize_memory(buffers[i], 0);
+  }
+  planes = resize_memory(planes, 0);
+}
+
+/**
+ * Starts capturing the frames of a width by height renderer to a Y4M video
+ * at the provided path, played back at the provided frames per second.
+ *
+ * The frame rate should be the rate at which frames are presented.
+ *
+ * All buffers are allocated here and the file is written by a background
+ * thread, so that capturing a frame never waits for the disk.
+ */
+Code initialize_capture(const char *path, const int width, const int height,
+                        const int frame_rate) {
+  const size_t pixel_count = width * height;
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  size_t i;
+  file = fopen(path, "wb");
+  if (file == NULL) {
+    sprintf(log_buffer, "Failed to open %.64s for capturing", path);
+    log_message(log_buffer);
+    return CODE_ERROR;
+  }
+  fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height,
+          frame_rate);
+  frame_width = width;
+  frame_height = height;
+  for (i = 0; i < CAPTURE_BUFFER_COUNT; i++) {
+    buffers[i] = resize_memory(NULL, BYTES_PER_PIXEL * pixel_count);
+  }
+  planes = resize_memory(NULL, 3 * pixel_count);
+  fill_index = 0;
+  write_index = 0;
+  filled_count = 0;
+  is_stopping = 0;
+  captured_frames = 0;
+  dropped_frames = 0;
+  mutex = SDL_CreateMutex();
+  condition = SDL_CreateCond();
+  if (mutex != NULL && condition != NULL) {
+    writer = SDL_CreateThread(write_frames, "capture", NULL);
+  }
+  if (writer == NULL) {
+    sprintf(log_buffer, "Failed to start the capture: %s", SDL_GetError());
+    log_message(log_buffer);
+    SDL_DestroyCond(condition);
+    condition = NULL;
+    SDL_DestroyMutex(mutex);
+    mutex = NULL;
+    free_buffers();
+    fclose(file);
+    file = NULL;
+    return CODE_ERROR;
+  }
+  sprintf(log_buffer, "Capturing %dx%d frames to %.64s", width, height, path);
+  log_message(log_buffer);
+  return CODE_OK;
+}
+
+/**
+ * Evaluates whether or not frames are being captured.
+ */
+int is_capturing(void) { return writer != NULL; }
+
+/**
+ * Reads back what the renderer is about to present and queues it for writing.
+ *
+ * Should be called right before presenting. If the writer fell behind, the
+ * frame is dropped. If the writer stopped after failing to write, nothing is
+ * done.
+ */
+void capture_frame(SDL_Renderer *renderer) {
+  const Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+  const int pitch = BYTES_PER_PIXEL * frame_width;
+  Milliseconds start;
+  int is_full;
+  int has_stopped;
+  if (!is_capturing()) {
+    return;
+  }
+  SDL_LockMutex(mutex);
+  is_full = filled_count == CAPTURE_BUFFER_COUNT;
+  has_stopped = is_stopping;
+  SDL_UnlockMutex(mutex);
+  if (has_stopped) {
+    return;
+  }
+  if (is_full) {
+    dropped_frames++;
+    return;
+  }
+  start = get_milliseconds();
+  SDL_RenderReadPixels(renderer, NULL, format, buffers[fill_index], pitch);
+  update_profiler("capture:read_pixels", get_milliseconds() - start);
+  fill_index = (fill_index + 1) % CAPTURE_BUFFER_COUNT;
+  captured_frames++;
+  SDL_LockMutex(mutex);
+  filled_count++;
+  SDL_CondSignal(condition);
+  SDL_UnlockMutex(mutex);
+}
+
+/**
+ * Writes all queued frames, stops the writer, and frees the buffers.
+ */
+void finalize_capture(void) {
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  if (!is_capturing()) {
+    return;
+  }
+  SDL_LockMutex(mutex);
+  is_stopping = 1;
+  SDL_CondSignal(condition);
+  SDL_UnlockMutex(mutex);
+  SDL_WaitThread(writer, NULL);
+  writer = NULL;
+  SDL_DestroyCond(condition);
+  condition = NULL;
+  SDL_DestroyMutex(mutex);
+  mutex = NULL;
+  free_buffers();
+  if (fclose(file) == EOF) {
+    log_message("Failed to finish writing the capture");
+  }
+  file = NULL;
+  sprintf(log_buffer, "Captured %lu frames and dropped %lu frames",
+          captured_frames, dropped_frames);
+  log_message(log_buffer);
+  update_profiler_count_histogram("capture:dropped_frames", dropped_frames);
+}
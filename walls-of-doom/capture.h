@@ -0,0 +1,46 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "code.h"
+
+#include <SDL.h>
+
+/**
+ * How many frames may be waiting to be written at the same time.
+ *
+ * Frames presented while all buffers are waiting are dropped.
+ */
+#define CAPTURE_BUFFER_COUNT 8
+
+/**
+ * Starts capturing the frames of a width by height renderer to a Y4M video
+ * at the provided path, played back at the provided frames per second.
+ *
+ * The frame rate should be the rate at which frames are presented.
+ *
+ * All buffers are allocated here and the file is written by a background
+ * thread, so that capturing a frame never waits for the disk.
+ */
+Code initialize_capture(const char *path, const int width, const int height,
+                        const int frame_rate);
+
+/**
+ * Evaluates whether or not frames are being captured.
+ */
+int is_capturing(void);
+
+/**
+ * Reads back what the renderer is about to present and queues it for writing.
+ *
+ * Should be called right before presenting. If the writer fell behind, the
+ * frame is dropped. If the writer stopped after failing to write, nothing is
+ * done.
+ */
+void capture_frame(SDL_Renderer *renderer);
+
+/**
+ * Writes all queued frames, stops the writer, and frees the buffers.
+ */
+void finalize_capture(void);
+
+#endif
@@ -10,3 +10,19 @@
  * This function should be used to measure computation times.
  */
 Milliseconds get_milliseconds(void) { return SDL_GetTicks(); }
+
+/**
+ * Returns the number of microseconds of a monotonic clock.
+ *
+ * This clock does not go back when the system time changes, so it should be
+ * used to schedule frames.
+ */
+Microseconds get_microseconds(void) {
+  const Uint64 counter = SDL_GetPerformanceCounter();
+  const Uint64 frequency = SDL_GetPerformanceFrequency();
+  /* Split the conversion so that the multiplication cannot overflow. */
+  const Uint64 seconds = counter / frequency;
+  const Uint64 remainder = counter % frequency;
+  return seconds * MICROSECONDS_IN_ONE_SECOND +
+         remainder * MICROSECONDS_IN_ONE_SECOND / frequency;
+}
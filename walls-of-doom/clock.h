@@ -4,6 +4,9 @@
 #include <stdint.h>
 
 typedef uint32_t Milliseconds;
+typedef uint64_t Microseconds;
+
+#define MICROSECONDS_IN_ONE_SECOND 1000000UL
 
 /**
  * Returns a number of milliseconds.
@@ -12,4 +15,12 @@ typedef uint32_t Milliseconds;
  */
 Milliseconds get_milliseconds(void);
 
+/**
+ * Returns the number of microseconds of a monotonic clock.
+ *
+ * This clock does not go back when the system time changes, so it should be
+ * used to schedule frames.
+ */
+Microseconds get_microseconds(void);
+
 #endif
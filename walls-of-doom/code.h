@@ -4,6 +4,6 @@
 /*
  * Codes passed between functions.
  */
-typedef enum Code { CODE_OK, CODE_QUIT, CODE_ERROR } Code;
+typedef enum Code { CODE_OK, CODE_QUIT, CODE_ERROR, CODE_REDRAW } Code;
 
 #endif
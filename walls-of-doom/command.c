@@ -0,0 +1,54 @@
+#include "command.h"
+
+#include "code.h"
+
+#include <SDL.h>
+
+#define INDEX_MODULUS (2 * COMMAND_QUEUE_SIZE)
+
+void initialize_command_queue(CommandQueue *const queue) {
+  SDL_AtomicSet(&queue->read_index, 0);
+  SDL_AtomicSet(&queue->write_index, 0);
+  SDL_AtomicSet(&queue->dropped_count, 0);
+}
+
+/**
+ * Appends a TimedCommand to the queue.
+ *
+ * Returns CODE_ERROR if the queue was full and the TimedCommand was dropped.
+ */
+Code push_command(CommandQueue *const queue, const TimedCommand command) {
+  const int write_index = SDL_AtomicGet(&queue->write_index);
+  const int read_index = SDL_AtomicGet(&queue->read_index);
+  const int used = (write_index - read_index + INDEX_MODULUS) % INDEX_MODULUS;
+  if (used == COMMAND_QUEUE_SIZE) {
+    SDL_AtomicAdd(&queue->dropped_count, 1);
+    return CODE_ERROR;
+  }
+  queue->commands[write_index % COMMAND_QUEUE_SIZE] = command;
+  /* SDL_AtomicSet is a full barrier, so the command is written before this. */
+  SDL_AtomicSet(&queue->write_index, (write_index + 1) % INDEX_MODULUS);
+  return CODE_OK;
+}
+
+/**
+ * Removes the oldest TimedCommand of the queue and writes it to command.
+ *
+ * Returns 0 if the queue was empty.
+ */
+int pop_command(CommandQueue *const queue, TimedCommand *const command) {
+  const int read_index = SDL_AtomicGet(&queue->read_index);
+  if (read_index == SDL_AtomicGet(&queue->write_index)) {
+    return 0;
+  }
+  *command = queue->commands[read_index % COMMAND_QUEUE_SIZE];
+  SDL_AtomicSet(&queue->read_index, (read_index + 1) % INDEX_MODULUS);
+  return 1;
+}
+
+/**
+ * Returns how many TimedCommands were dropped because the queue was full.
+ */
+int get_dropped_command_count(CommandQueue *const queue) {
+  return SDL_AtomicGet(&queue->dropped_count);
+}
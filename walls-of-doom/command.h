@@ -1,6 +1,11 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
+#include "clock.h"
+#include "code.h"
+
+#include <SDL.h>
+
 /**
  * The Command enumerated type represents the different commands the user may
  * issue.
@@ -17,4 +22,54 @@ typedef enum Command {
   COMMAND_QUIT
 } Command;
 
+/**
+ * A Command and when the user issued it, on the get_milliseconds() clock.
+ */
+typedef struct TimedCommand {
+  Command command;
+  Milliseconds timestamp;
+} TimedCommand;
+
+/**
+ * How many TimedCommands a CommandQueue holds.
+ */
+#define COMMAND_QUEUE_SIZE 32
+
+/**
+ * A lock-free ring buffer of TimedCommands, with a single writer and a single
+ * reader.
+ *
+ * Commands are read in the order they were written. Commands written while
+ * the queue is full are dropped and counted.
+ */
+typedef struct CommandQueue {
+  TimedCommand commands[COMMAND_QUEUE_SIZE];
+  /* Both indices are kept modulo twice the size, so that a full queue can be
+   * told apart from an empty one. */
+  SDL_atomic_t read_index;
+  SDL_atomic_t write_index;
+  SDL_atomic_t dropped_count;
+} CommandQueue;
+
+void initialize_command_queue(CommandQueue *const queue);
+
+/**
+ * Appends a TimedCommand to the queue.
+ *
+ * Returns CODE_ERROR if the queue was full and the TimedCommand was dropped.
+ */
+Code push_command(CommandQueue *const queue, const TimedCommand command);
+
+/**
+ * Removes the oldest TimedCommand of the queue and writes it to command.
+ *
+ * Returns 0 if the queue was empty.
+ */
+int pop_command(CommandQueue *const queue, TimedCommand *const command);
+
+/**
+ * Returns how many TimedCommands were dropped because the queue was full.
+ */
+int get_dropped_command_count(CommandQueue *const queue);
+
 #endif
@@ -1,15 +1,19 @@
 #include "game.h"
 
 #include "about.h"
+#include "clock.h"
 #include "constants.h"
 #include "data.h"
 #include "io.h"
 #include "logger.h"
-#include "menu.h"
+#include "memory.h"
+#include "options.h"
 #include "physics.h"
-#include "random.h"
+#include "platform.h"
+#include "profiler.h"
 #include "record.h"
 #include "rest.h"
+#include "snapshot.h"
 #include "version.h"
 
 #include <stdlib.h>
@@ -18,34 +22,92 @@
 #include <SDL.h>
 
 /**
- * Creates a new Game object with the provided objects.
+ * How many frames the main loop may simulate without drawing to catch up.
  */
-Game create_game(Player *player, Platform *platforms,
-                 const size_t platform_count, BoundingBox *box) {
+#define MAXIMUM_CATCH_UP_STEPS 4
+
+/**
+ * How long before a step the game thread reads input for it.
+ */
+#define INPUT_SAMPLING_LEAD 1000
+
+/**
+ * What the game thread and the simulation thread share while a Game runs.
+ */
+typedef struct Simulation {
+  Game *game;
+  SnapshotExchange exchange;
+  /* Commands read by the game thread, applied in order by the next step. */
+  CommandQueue commands;
+  /* Set by the game thread when the player quits. */
+  SDL_atomic_t should_quit;
+  /* Set by the simulation thread when the Game is over. */
+  SDL_atomic_t is_over;
+  /* Set by the game thread while the window is not active. */
+  int is_paused;
+  /* How many Commands were applied in the same step as an earlier Command.
+   * Only written by the simulation thread. */
+  int coalesced_commands;
+  SDL_mutex *pause_mutex;
+  SDL_cond *resumed;
+} Simulation;
+
+static Simulation simulation;
+
+/**
+ * Creates a new Game object with the provided objects, simulated at the
+ * provided number of frames per second.
+ *
+ * The Game keeps copies of the provided Platforms.
+ */
+Game create_game(Player *player, const Platform *platforms,
+                 const size_t platform_count, BoundingBox *box,
+                 const int tick_rate) {
   Game game;
 
   game.player = player;
-  game.platforms = platforms;
+  game.platforms = create_platform_store(platforms, platform_count);
   game.platform_count = platform_count;
+  game.next_on_line = resize_memory(NULL, platform_count * sizeof(int));
+  index_platforms(&game);
 
   game.frame = 0;
   game.played_frames = 0;
 
+  game.tick_rate = tick_rate;
+  game.perk_interval_frames = PERK_INTERVAL_IN_SECONDS * tick_rate;
+  game.perk_screen_duration_frames =
+      PERK_SCREEN_DURATION_IN_SECONDS * tick_rate;
+  game.perk_player_duration_frames =
+      PERK_PLAYER_DURATION_IN_SECONDS * tick_rate;
+
   game.box = box;
 
   game.perk = PERK_NONE;
   game.perk_x = 0;
   game.perk_y = 0;
   /* Don't start with a Perk on the screen. */
-  game.perk_end_frame = PERK_SCREEN_DURATION_IN_FRAMES;
+  game.perk_end_frame = game.perk_screen_duration_frames;
 
   game.message[0] = '\0';
 
+  initialize_movement_schedule(&game);
+
+  cache_static_layer(box);
+
   log_message("Finished creating the game");
 
   return game;
 }
 
+/**
+ * Frees the resources of the provided Game which create_game allocated.
+ */
+void destroy_game(Game *const game) {
+  game->next_on_line = resize_memory(game->next_on_line, 0);
+  destroy_platform_store(&game->platforms);
+}
+
 /**
  * Returns 0 if the screen size has not changed since the creation of the
  * provided Game.
@@ -76,57 +138,389 @@ void register_score(const Game *const game, SDL_Renderer *renderer) {
   sprintf(buffer, "Saved the record successfully");
   log_message(buffer);
 
-  print_game_result(player->name, player->score, position, renderer);
-  wait_for_input();
+  do {
+    print_game_result(player->name, player->score, position, renderer);
+  } while (wait_for_input() == CODE_REDRAW);
+}
+
+/**
+ * Advances the provided Game by one frame, applying the provided Commands in
+ * order.
+ */
+static void step_game(Game *const game, const Command *commands,
+                      const size_t command_count,
+                      unsigned long *next_played_frames_score) {
+  /* 1. Update the score */
+  if (game->played_frames == *next_played_frames_score) {
+    game->player->score++;
+    *next_played_frames_score += game->tick_rate;
+  }
+  /* 2. Update the platforms */
+  update_platforms(game);
+  /* 3. Update the perk */
+  update_perk(game);
+  /* 4. Update the player using the commands */
+  update_player_with_commands(game, commands, command_count);
+  /* 5. Increment the frame counter */
+  advance_frame(game);
+}
+
+static int is_game_over(Simulation *const simulation) {
+  const Game *const game = simulation->game;
+  /* Checking for any nonpositive player.lives value would be safer but could
+   * hide some bugs */
+  return SDL_AtomicGet(&simulation->should_quit) ||
+         check_for_screen_size_change(game) || game->player->lives == 0;
+}
+
+/**
+ * Returns how much of the step that ends at the provided deadline has
+ * passed, from 0 to 1.
+ */
+static double step_progress(const Microseconds deadline,
+                            const Microseconds period) {
+  const Microseconds now = get_microseconds();
+  if (now + period <= deadline) {
+    return 0.0;
+  }
+  if (now >= deadline) {
+    return 1.0;
+  }
+  return 1.0 - (deadline - now) / (double)period;
+}
+
+/**
+ * Takes all queued Commands, up to COMMAND_QUEUE_SIZE, in the order they were
+ * issued.
+ *
+ * Writes when the first of them was issued to timestamp.
+ *
+ * Returns how many Commands were taken.
+ */
+static size_t take_commands(Simulation *const simulation, Command *commands,
+                            Milliseconds *timestamp) {
+  TimedCommand command;
+  size_t count = 0;
+  while (count < COMMAND_QUEUE_SIZE &&
+         pop_command(&simulation->commands, &command)) {
+    if (count == 0) {
+      *timestamp = command.timestamp;
+    }
+    commands[count++] = command.command;
+  }
+  return count;
+}
+
+/**
+ * Reads input and queues the Commands for the next step.
+ */
+static void send_commands(Simulation *const simulation) {
+  if (read_commands(&simulation->commands) == CODE_QUIT) {
+    SDL_AtomicSet(&simulation->should_quit, 1);
+  }
+}
+
+/**
+ * Pauses or resumes the provided Simulation.
+ */
+static void set_paused(Simulation *const simulation, const int is_paused) {
+  SDL_LockMutex(simulation->pause_mutex);
+  simulation->is_paused = is_paused;
+  if (!is_paused) {
+    SDL_CondSignal(simulation->resumed);
+  }
+  SDL_UnlockMutex(simulation->pause_mutex);
+}
+
+/**
+ * Blocks the simulation thread while the provided Simulation is paused.
+ *
+ * Returns whether or not it was paused.
+ */
+static int wait_while_paused(Simulation *const simulation) {
+  int was_paused = 0;
+  SDL_LockMutex(simulation->pause_mutex);
+  while (simulation->is_paused) {
+    was_paused = 1;
+    SDL_CondWait(simulation->resumed, simulation->pause_mutex);
+  }
+  SDL_UnlockMutex(simulation->pause_mutex);
+  return was_paused;
+}
+
+/**
+ * Simulates the Game of the provided Simulation until it is over,
+ * publishing a SimulationState after every batch of steps.
+ *
+ * Steps are scheduled on absolute deadlines. When the thread falls behind,
+ * up to MAXIMUM_CATCH_UP_STEPS steps are simulated before publishing, and any
+ * time beyond that is recorded as an overrun and skipped.
+ *
+ * While the Simulation is paused, this thread blocks. The step deadlines are
+ * rebased when it resumes, so that the pause is not caught up.
+ */
+static int run_simulation(void *data) {
+  Simulation *const simulation = (Simulation *)data;
+  Game *const game = simulation->game;
+  const Microseconds period = MICROSECONDS_IN_ONE_SECOND / game->tick_rate;
+  unsigned long next_played_frames_score = game->tick_rate;
+  Microseconds deadline = get_microseconds();
+  Microseconds now;
+  SimulationState *state;
+  Snapshot previous;
+  Snapshot current;
+  Command commands[COMMAND_QUEUE_SIZE];
+  size_t command_count;
+  Milliseconds timestamp;
+  int has_input = 0;
+  Milliseconds input_timestamp = 0;
+  int steps;
+  initialize_snapshot(&previous);
+  initialize_snapshot(&current);
+  take_snapshot(game, &current);
+  while (!is_game_over(simulation)) {
+    if (wait_while_paused(simulation)) {
+      deadline = get_microseconds() + period;
+      continue;
+    }
+    rest_until(deadline);
+    now = get_microseconds();
+    steps = 0;
+    while (deadline <= now && steps < MAXIMUM_CATCH_UP_STEPS &&
+           !is_game_over(simulation)) {
+      /* Commands are only applied to the first of the catch up steps. */
+      command_count = 0;
+      if (steps == 0) {
+        command_count = take_commands(simulation, commands, &timestamp);
+        if (command_count > 0 && !has_input) {
+          has_input = 1;
+          input_timestamp = timestamp;
+        }
+        if (command_count > 1) {
+          simulation->coalesced_commands += command_count - 1;
+        }
+      }
+      step_game(game, commands, command_count, &next_played_frames_score);
+      copy_snapshot(&previous, &current);
+      take_snapshot(game, &current);
+      deadline += period;
+      steps++;
+    }
+    if (deadline <= now) {
+      update_profiler("run_game:overrun", (now - deadline) / 1000);
+      deadline = now + period;
+    }
+    if (steps > 0) {
+      state = get_back_state(&simulation->exchange);
+      copy_snapshot(&state->previous, &previous);
+      copy_snapshot(&state->current, &current);
+      state->deadline = deadline;
+      state->has_input = has_input;
+      state->input_timestamp = input_timestamp;
+      publish_back_state(&simulation->exchange);
+      has_input = 0;
+    }
+  }
+  destroy_snapshot(&previous);
+  destroy_snapshot(&current);
+  SDL_AtomicSet(&simulation->is_over, 1);
+  return 0;
+}
+
+/**
+ * Pauses the provided Simulation until the window is active again.
+ *
+ * If the player quits or waiting fails, the Simulation is resumed with
+ * should_quit set, even though the window may still be inactive.
+ */
+static void pause_until_active(Simulation *const simulation) {
+  log_message("Paused the game while the window is not active");
+  set_paused(simulation, 1);
+  if (wait_for_active_window() != CODE_OK) {
+    SDL_AtomicSet(&simulation->should_quit, 1);
+  }
+  set_paused(simulation, 0);
+  log_message("Resumed the game");
+}
+
+static void destroy_pause(Simulation *const simulation) {
+  SDL_DestroyCond(simulation->resumed);
+  simulation->resumed = NULL;
+  SDL_DestroyMutex(simulation->pause_mutex);
+  simulation->pause_mutex = NULL;
+}
+
+/**
+ * Returns when the game thread should wake up next, which is when it should
+ * draw or right before the next step, to read input for it.
+ */
+static Microseconds next_wake_up(const Microseconds draw_deadline,
+                                 const Microseconds step_deadline) {
+  const Microseconds sampling_time = step_deadline - INPUT_SAMPLING_LEAD;
+  if (sampling_time > get_microseconds() && sampling_time < draw_deadline) {
+    return sampling_time;
+  }
+  return draw_deadline;
 }
 
 /**
  * Runs the main loop of the provided game and registers the player score at the
  * end.
  *
+ * The game is simulated at its tick rate on a separate thread, so that
+ * drawing never delays a step. This thread reads input right before every
+ * step and draws the latest SimulationState at the refresh rate of the
+ * screen, interpolating between its two Snapshots. SDL requires rendering and
+ * event handling to stay on the thread which created the window.
+ *
+ * While the window is hidden, minimized or unfocused, the simulation is paused
+ * and nothing is drawn until the window is active again.
+ *
+ * Every Command read is queued and applied, in order, by the next step. The
+ * time from a Command being issued to the first present which shows its
+ * effect is recorded in the run_game:input_latency histogram. How many
+ * Commands were dropped because the queue was full, and how many were applied
+ * in the same step as an earlier Command, are recorded for every game in the
+ * run_game:dropped_commands and run_game:coalesced_commands histograms.
+ *
  * Returns 0 if successful.
  */
 int run_game(Game *const game, SDL_Renderer *renderer) {
-  unsigned long next_played_frames_score = FPS;
-  Command command = COMMAND_NONE;
-  /* Checking for any nonpositive player.lives value would be safer but could
-   * hide some bugs */
-  while (command != COMMAND_QUIT && !check_for_screen_size_change(game) &&
-         game->player->lives != 0) {
-    /* Game loop */
-    /* 1. Update the score */
-    if (game->played_frames == next_played_frames_score) {
-      game->player->score++;
-      next_played_frames_score += FPS;
+  const Microseconds period = MICROSECONDS_IN_ONE_SECOND / game->tick_rate;
+  const Microseconds draw_period =
+      MICROSECONDS_IN_ONE_SECOND / get_refresh_rate();
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  Microseconds draw_deadline = get_microseconds();
+  unsigned long measured_frame = 0;
+  int dropped_commands;
+  const SimulationState *latest;
+  SimulationState *initial;
+  SDL_Thread *thread = NULL;
+  simulation.game = game;
+  initialize_command_queue(&simulation.commands);
+  SDL_AtomicSet(&simulation.should_quit, 0);
+  SDL_AtomicSet(&simulation.is_over, 0);
+  simulation.is_paused = 0;
+  simulation.coalesced_commands = 0;
+  initialize_snapshot_exchange(&simulation.exchange);
+  /* Publish the initial state, so that there is always a state to draw. */
+  initial = get_back_state(&simulation.exchange);
+  take_snapshot(game, &initial->current);
+  copy_snapshot(&initial->previous, &initial->current);
+  initial->deadline = draw_deadline + period;
+  initial->has_input = 0;
+  publish_back_state(&simulation.exchange);
+  simulation.pause_mutex = SDL_CreateMutex();
+  simulation.resumed = SDL_CreateCond();
+  if (simulation.pause_mutex != NULL && simulation.resumed != NULL) {
+    thread = SDL_CreateThread(run_simulation, "simulation", &simulation);
+  }
+  if (thread == NULL) {
+    sprintf(log_buffer, "Failed to start the simulation: %s", SDL_GetError());
+    log_message(log_buffer);
+    destroy_pause(&simulation);
+    destroy_snapshot_exchange(&simulation.exchange);
+    return 1;
+  }
+  while (!SDL_AtomicGet(&simulation.is_over)) {
+    send_commands(&simulation);
+    /* After the player quits, the simulation must not be paused again, as it
+     * has to run until it sees the quit and ends the game. */
+    if (!is_window_active() && !SDL_AtomicGet(&simulation.should_quit)) {
+      pause_until_active(&simulation);
+      draw_deadline = get_microseconds();
+      continue;
     }
-    /* 2. Update the platforms */
-    update_platforms(game);
-    /* 3. Update the perk */
-    update_perk(game);
-    /* 4. Draw everything */
-    draw_game(game, renderer);
-    /* 5. Sleep */
-    rest_for_second_fraction(FPS);
-    /* 6. Read whatever command we got (if any) */
-    command = read_next_command();
-    /* 7. Update the player using the command */
-    update_player(game, command);
-    /* 8. Increment the frame counter */
-    game->frame++;
+    latest = get_latest_state(&simulation.exchange);
+    if (get_microseconds() >= draw_deadline) {
+      draw_snapshots(&latest->previous, &latest->current,
+                     step_progress(latest->deadline, period), renderer);
+      if (latest->has_input && latest->current.frame != measured_frame) {
+        update_profiler_histogram("run_game:input_latency",
+                                  get_milliseconds() - latest->input_timestamp);
+        measured_frame = latest->current.frame;
+      }
+      /* Draw deadlines which were missed are skipped. */
+      draw_deadline += draw_period;
+      if (draw_deadline <= get_microseconds()) {
+        draw_deadline = get_microseconds() + draw_period;
+      }
+    }
+    rest_until(next_wake_up(draw_deadline, latest->deadline));
+  }
+  SDL_WaitThread(thread, NULL);
+  destroy_pause(&simulation);
+  destroy_snapshot_exchange(&simulation.exchange);
+  dropped_commands = get_dropped_command_count(&simulation.commands);
+  if (dropped_commands > 0) {
+    sprintf(log_buffer, "Dropped %d commands", dropped_commands);
+    log_message(log_buffer);
+  }
+  if (simulation.coalesced_commands > 0) {
+    sprintf(log_buffer, "Coalesced %d commands", simulation.coalesced_commands);
+    log_message(log_buffer);
   }
+  update_profiler_count_histogram("run_game:dropped_commands",
+                                  dropped_commands);
+  update_profiler_count_histogram("run_game:coalesced_commands",
+                                  simulation.coalesced_commands);
   /* Ignoring how the game ended (quit command, screen resize, or death),
    * register the score */
   register_score(game, renderer);
   return 0;
 }
 
-int main(void) {
-  int result;
-  SDL_Window *window;
-  SDL_Renderer *renderer;
-  seed_random();
-  initialize(&window, &renderer);
-  result = main_menu(renderer);
-  finalize(&window, &renderer);
-  return result;
+/**
+ * Runs BENCHMARK_FRAME_COUNT frames of a game without input and without
+ * resting between frames.
+ *
+ * The cost of each step is recorded by the profiler, and the cost of updating
+ * the Platforms is recorded in the run_benchmark:update_platforms histogram.
+ *
+ * Returns 0 if successful.
+ */
+int run_benchmark(SDL_Renderer *renderer) {
+  char name[] = "Benchmark";
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  Player player;
+  const int platform_count = get_options()->platform_count;
+  Platform *platforms;
+  BoundingBox box;
+  Game game;
+  Milliseconds start;
+  Microseconds update_start;
+
+  player = make_player(name);
+  player.x = COLUMNS / 2;
+  player.y = LINES / 2;
+
+  box = bounding_box_from_screen();
+
+  platforms = resize_memory(NULL, platform_count * sizeof(Platform));
+  generate_platforms(platforms, platform_count);
+
+  game = create_game(&player, platforms, platform_count, &box,
+                     get_options()->tick_rate);
+  platforms = resize_memory(platforms, 0);
+
+  sprintf(log_buffer,
+          "Started running the benchmark with %d platforms at %d frames per "
+          "second",
+          platform_count, game.tick_rate);
+  log_message(log_buffer);
+  while (game.frame < BENCHMARK_FRAME_COUNT) {
+    start = get_milliseconds();
+    update_start = get_microseconds();
+    update_platforms(&game);
+    update_profiler_microsecond_histogram("run_benchmark:update_platforms",
+                                          get_microseconds() - update_start);
+    update_perk(&game);
+    draw_game(&game, renderer);
+    update_player(&game, COMMAND_NONE);
+    advance_frame(&game);
+    update_profiler("run_benchmark:frame", get_milliseconds() - start);
+  }
+  destroy_game(&game);
+  log_message("Finished running the benchmark");
+  return 0;
 }
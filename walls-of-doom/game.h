@@ -10,17 +10,94 @@
 #include "player.h"
 #include "random.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <SDL.h>
 
+/**
+ * How many cells each word of the occupancy grid holds.
+ */
+#define OCCUPANCY_WORD_SIZE 64
+#define OCCUPANCY_WORDS_PER_LINE                                               \
+  ((COLUMNS + OCCUPANCY_WORD_SIZE - 1) / OCCUPANCY_WORD_SIZE)
+
+#if LINES > 64
+#error "The free lines of a Game must fit in a single word."
+#endif
+
+/**
+ * The greatest speed the movement schedule of a Game holds. Faster objects are
+ * scheduled by division.
+ */
+#define MAXIMUM_SCHEDULED_SPEED 32
+
+/**
+ * When objects of each speed move, so that checking it takes no division.
+ */
+typedef struct MovementSchedule {
+  /**
+   * The tick rate the multiples are for.
+   *
+   * A schedule is only used if its tick rate and frame match the Game, so
+   * that Games whose schedule was never built, or whose tick rate changed,
+   * fall back to dividing.
+   */
+  int tick_rate;
+
+  /**
+   * The frame the countdowns are for.
+   */
+  unsigned long frame;
+
+  /**
+   * Every how many frames objects of each speed move.
+   */
+  unsigned long multiple[MAXIMUM_SCHEDULED_SPEED + 1];
+
+  /**
+   * In how many frames objects of each speed move next, zero if they move in
+   * the current frame.
+   */
+  unsigned long countdown[MAXIMUM_SCHEDULED_SPEED + 1];
+} MovementSchedule;
+
 typedef struct Game {
 
   Player *player;
 
-  Platform *platforms;
+  PlatformStore platforms;
   size_t platform_count;
 
+  /**
+   * The index of the first Platform on each line, or -1.
+   *
+   * Lines are y coordinates clamped to the screen, so Platforms above or below
+   * it share the first or the last list.
+   */
+  int first_on_line[LINES];
+
+  /**
+   * The index of the next Platform on the line of each Platform, or -1.
+   */
+  int *next_on_line;
+
+  /**
+   * One bit for every line, set if no Platform is on the line.
+   */
+  uint64_t free_lines;
+
+  /**
+   * One bit for every cell of the screen, set if a Platform covers the cell.
+   */
+  uint64_t occupancy[LINES][OCCUPANCY_WORDS_PER_LINE];
+
+  /**
+   * How many Platforms cover each cell of the screen, so that the occupancy
+   * grid can be updated one cell at a time as Platforms move.
+   */
+  int coverage[LINES][COLUMNS];
+
   /**
    * In which frame - starting at 0 - we are now.
    */
@@ -31,6 +108,20 @@ typedef struct Game {
    */
   unsigned long played_frames;
 
+  /**
+   * How many frames are simulated per second.
+   */
+  int tick_rate;
+
+  /**
+   * The Perk durations, in frames, derived from the tick rate.
+   */
+  unsigned long perk_interval_frames;
+  unsigned long perk_screen_duration_frames;
+  unsigned long perk_player_duration_frames;
+
+  MovementSchedule schedule;
+
   Perk perk;
   int perk_x;
   int perk_y;
@@ -43,10 +134,19 @@ typedef struct Game {
 } Game;
 
 /**
- * Creates a new Game object with the provided objects.
+ * Creates a new Game object with the provided objects, simulated at the
+ * provided number of frames per second.
+ *
+ * The Game keeps copies of the provided Platforms.
+ */
+Game create_game(Player *player, const Platform *platforms,
+                 const size_t platform_count, BoundingBox *box,
+                 const int tick_rate);
+
+/**
+ * Frees the resources of the provided Game which create_game allocated.
  */
-Game create_game(Player *player, Platform *platforms,
-                 const size_t platform_count, BoundingBox *box);
+void destroy_game(Game *const game);
 
 void update_game(Game *const game);
 
@@ -58,4 +158,15 @@ void update_game(Game *const game);
  */
 int run_game(Game *const game, SDL_Renderer *renderer);
 
+/**
+ * Runs BENCHMARK_FRAME_COUNT frames of a game without input and without
+ * resting between frames.
+ *
+ * The cost of each step is recorded by the profiler, and the cost of updating
+ * the Platforms is recorded in the run_benchmark:update_platforms histogram.
+ *
+ * Returns 0 if successful.
+ */
+int run_benchmark(SDL_Renderer *renderer);
+
 #endif
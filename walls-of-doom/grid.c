@@ -0,0 +1,73 @@
+#include "grid.h"
+
+#include "color.h"
+#include "constants.h"
+#include "numeric.h"
+
+int cell_equals(const Cell a, const Cell b) {
+  return a.glyph == b.glyph && color_pair_equals(a.color_pair, b.color_pair);
+}
+
+/**
+ * Fills all the Cells of the Grid with spaces of the provided ColorPair.
+ */
+void clear_grid(Grid *const grid, const ColorPair color_pair) {
+  Cell empty;
+  int x;
+  int y;
+  empty.glyph = ' ';
+  empty.color_pair = color_pair;
+  for (y = 0; y < LINES; y++) {
+    for (x = 0; x < COLUMNS; x++) {
+      grid->cells[y][x] = empty;
+    }
+  }
+}
+
+/**
+ * Writes the provided string to a row of COLUMNS Cells starting at x.
+ *
+ * Characters which would be outside of the row are discarded.
+ */
+void write_string_to_row(Cell *const row, const int x, const char *string,
+                         const ColorPair color_pair) {
+  int i;
+  for (i = 0; string[i] != '\0' && x + i < COLUMNS; i++) {
+    if (x + i >= 0) {
+      row[x + i].glyph = string[i];
+      row[x + i].color_pair = color_pair;
+    }
+  }
+}
+
+/**
+ * Writes the provided string to the Grid starting at (x, y).
+ *
+ * Characters which would be outside of the Grid are discarded.
+ */
+void write_string_to_grid(Grid *const grid, const int x, const int y,
+                          const char *string, const ColorPair color_pair) {
+  if (y < 0 || y >= LINES) {
+    return;
+  }
+  write_string_to_row(grid->cells[y], x, string, color_pair);
+}
+
+/**
+ * Fills width Cells starting at (x, y) with spaces of the provided ColorPair.
+ *
+ * Cells which would be outside of the Grid are discarded.
+ */
+void fill_grid_span(Grid *const grid, const int x, const int y,
+                    const int width, const ColorPair color_pair) {
+  Cell *cell;
+  int i;
+  if (y < 0 || y >= LINES) {
+    return;
+  }
+  for (i = max(0, x); i < x + width && i < COLUMNS; i++) {
+    cell = &grid->cells[y][i];
+    cell->glyph = ' ';
+    cell->color_pair = color_pair;
+  }
+}
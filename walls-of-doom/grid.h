@@ -0,0 +1,53 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "color.h"
+#include "constants.h"
+
+/**
+ * A Cell is a single character position of the screen.
+ */
+typedef struct Cell {
+  char glyph;
+  ColorPair color_pair;
+} Cell;
+
+/**
+ * A Grid holds what should be shown on each Cell of the screen.
+ */
+typedef struct Grid {
+  Cell cells[LINES][COLUMNS];
+} Grid;
+
+int cell_equals(const Cell a, const Cell b);
+
+/**
+ * Fills all the Cells of the Grid with spaces of the provided ColorPair.
+ */
+void clear_grid(Grid *const grid, const ColorPair color_pair);
+
+/**
+ * Writes the provided string to a row of COLUMNS Cells starting at x.
+ *
+ * Characters which would be outside of the row are discarded.
+ */
+void write_string_to_row(Cell *const row, const int x, const char *string,
+                         const ColorPair color_pair);
+
+/**
+ * Writes the provided string to the Grid starting at (x, y).
+ *
+ * Characters which would be outside of the Grid are discarded.
+ */
+void write_string_to_grid(Grid *const grid, const int x, const int y,
+                          const char *string, const ColorPair color_pair);
+
+/**
+ * Fills width Cells starting at (x, y) with spaces of the provided ColorPair.
+ *
+ * Cells which would be outside of the Grid are discarded.
+ */
+void fill_grid_span(Grid *const grid, const int x, const int y,
+                    const int width, const ColorPair color_pair);
+
+#endif
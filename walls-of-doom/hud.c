@@ -0,0 +1,94 @@
+#include "hud.h"
+
+#include "color.h"
+#include "constants.h"
+#include "grid.h"
+#include "perk.h"
+#include "player.h"
+#include "text.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Makes the next call to update_hud rebuild both bars.
+ */
+void invalidate_hud(Hud *const hud) { hud->is_valid = 0; }
+
+/**
+ * Writes one of the TOP_BAR_STRING_COUNT strings of the top bar, centered in
+ * its segment of the provided row.
+ *
+ * Strings which do not fit in their segment are not written.
+ */
+void write_top_bar_string(Cell *const row, const int index,
+                          const char *string) {
+  const int columns_per_string = COLUMNS / TOP_BAR_STRING_COUNT;
+  const int begin_x = index * columns_per_string;
+  const int string_length = strlen(string);
+  int x;
+  if (string_length < columns_per_string) {
+    /* Write the string because it fits. */
+    x = begin_x + (columns_per_string - string_length) / 2;
+    write_string_to_row(row, x, string, TOP_BAR_COLOR);
+  }
+}
+
+static void build_top_bar(Hud *const hud, const Grid *const layer) {
+  char power_buffer[MAXIMUM_STRING_SIZE];
+  char lives_buffer[MAXIMUM_STRING_SIZE];
+  char score_buffer[MAXIMUM_STRING_SIZE];
+  if (hud->perk != PERK_NONE) {
+    sprintf(power_buffer, "%s", get_perk_name(hud->perk));
+  } else {
+    sprintf(power_buffer, "No Power");
+  }
+  sprintf(lives_buffer, "Lives: %d", hud->lives);
+  sprintf(score_buffer, "Score: %d", hud->score);
+  memcpy(hud->top_bar, layer->cells[0], sizeof(hud->top_bar));
+  /* The first string, the name of the game, is part of the layer. */
+  write_top_bar_string(hud->top_bar, 1, power_buffer);
+  write_top_bar_string(hud->top_bar, 2, lives_buffer);
+  write_top_bar_string(hud->top_bar, 3, score_buffer);
+}
+
+static void build_bottom_bar(Hud *const hud, const Grid *const layer) {
+  memcpy(hud->bottom_bar, layer->cells[LINES - 1], sizeof(hud->bottom_bar));
+  write_string_to_row(hud->bottom_bar, 0, hud->message, BOTTOM_BAR_COLOR);
+}
+
+/**
+ * Updates the Hud to show the provided Player and message.
+ *
+ * The bars are rebuilt on top of the first and the last rows of the provided
+ * layer only if a value they show changed since the last call.
+ *
+ * Returns 1 if the bars were rebuilt.
+ */
+int update_hud(Hud *const hud, const Player *const player, const char *message,
+               const Grid *const layer) {
+  int changed = !hud->is_valid;
+  if (changed || hud->lives != player->lives || hud->score != player->score ||
+      hud->perk != player->perk) {
+    hud->lives = player->lives;
+    hud->score = player->score;
+    hud->perk = player->perk;
+    build_top_bar(hud, layer);
+    changed = 1;
+  }
+  if (!hud->is_valid || strcmp(hud->message, message) != 0) {
+    copy_string(hud->message, message, MAXIMUM_STRING_SIZE);
+    build_bottom_bar(hud, layer);
+    changed = 1;
+  }
+  hud->is_valid = 1;
+  return changed;
+}
+
+/**
+ * Copies the bars of the Hud to the first and the last rows of a Grid.
+ */
+void draw_hud(const Hud *const hud, Grid *const grid) {
+  memcpy(grid->cells[0], hud->top_bar, sizeof(hud->top_bar));
+  memcpy(grid->cells[LINES - 1], hud->bottom_bar, sizeof(hud->bottom_bar));
+}
@@ -0,0 +1,56 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "constants.h"
+#include "grid.h"
+#include "perk.h"
+#include "player.h"
+
+/**
+ * The Hud caches the top and the bottom bars of the game screen.
+ *
+ * The bars are only rebuilt when one of the values they show changes.
+ */
+typedef struct Hud {
+  int is_valid;
+
+  int lives;
+  int score;
+  Perk perk;
+  char message[MAXIMUM_STRING_SIZE];
+
+  Cell top_bar[COLUMNS];
+  Cell bottom_bar[COLUMNS];
+} Hud;
+
+/**
+ * Makes the next call to update_hud rebuild both bars.
+ */
+void invalidate_hud(Hud *const hud);
+
+/**
+ * Writes one of the TOP_BAR_STRING_COUNT strings of the top bar, centered in
+ * its segment of the provided row.
+ *
+ * Strings which do not fit in their segment are not written.
+ */
+void write_top_bar_string(Cell *const row, const int index,
+                          const char *string);
+
+/**
+ * Updates the Hud to show the provided Player and message.
+ *
+ * The bars are rebuilt on top of the first and the last rows of the provided
+ * layer only if a value they show changed since the last call.
+ *
+ * Returns 1 if the bars were rebuilt.
+ */
+int update_hud(Hud *const hud, const Player *const player, const char *message,
+               const Grid *const layer);
+
+/**
+ * Copies the bars of the Hud to the first and the last rows of a Grid.
+ */
+void draw_hud(const Hud *const hud, Grid *const grid);
+
+#endif
@@ -1,15 +1,21 @@
 #include "io.h"
 
+#include "capture.h"
 #include "clock.h"
 #include "constants.h"
 #include "game.h"
+#include "grid.h"
+#include "hud.h"
 #include "logger.h"
 #include "memory.h"
 #include "numeric.h"
+#include "options.h"
 #include "physics.h"
 #include "player.h"
 #include "profiler.h"
-#include "rest.h"
+#include "render.h"
+#include "snapshot.h"
+#include "terminal.h"
 
 #include <SDL.h>
 #include <SDL_image.h>
@@ -25,14 +31,102 @@
 
 #define IMG_FLAGS IMG_INIT_PNG
 
+/**
+ * The range of characters which have a glyph in the glyph atlas.
+ */
+#define FIRST_ATLAS_CHARACTER ' '
+#define LAST_ATLAS_CHARACTER '~'
+#define ATLAS_CHARACTER_COUNT (LAST_ATLAS_CHARACTER - FIRST_ATLAS_CHARACTER + 1)
+
+/**
+ * Presents further apart than this, in microseconds, are pauses between games
+ * rather than late frames.
+ */
+#define MAXIMUM_PACED_INTERVAL 250000
+
+/**
+ * The surface the software renderer draws to in headless mode.
+ */
+static SDL_Surface *headless_surface = NULL;
 static TTF_Font *global_monospaced_font = NULL;
 static int global_monospaced_font_width = 0;
 static int global_monospaced_font_height = 0;
-static SDL_Texture *borders_texture = NULL;
+/**
+ * A texture with all printable glyphs of the font in white over transparency.
+ *
+ * Glyphs are laid out in a single row, in character order, each one exactly
+ * one cell wide. Foregrounds are applied through color modulation and
+ * backgrounds are filled before the glyphs are copied, so this atlas serves
+ * every ColorPair.
+ */
+static SDL_Texture *glyph_atlas = NULL;
+
+/**
+ * Everything that does not change during a Game and the BoundingBox for which
+ * it was built.
+ */
+static Grid static_layer;
+static BoundingBox static_layer_box;
+static int static_layer_is_valid = 0;
+static Hud hud;
+/**
+ * The Grid draw_game composes every frame, starting from the static layer.
+ */
+static Grid back_grid;
+/**
+ * What the grid texture currently shows, used to find the Cells that changed.
+ */
+static Grid rendered_grid;
+static int rendered_grid_is_valid = 0;
+static SDL_Texture *grid_texture = NULL;
+/**
+ * The RenderCommands of the last frame drawn by draw_game.
+ */
+static RenderCommandBuffer frame_commands;
+/**
+ * The rectangles of consecutive fill commands of the same color.
+ */
+static SDL_Rect fill_rects[MAXIMUM_RENDER_COMMAND_COUNT];
+/**
+ * How many frames per second the screen shows.
+ */
+static int refresh_rate = FPS;
+/**
+ * When the last frame of a game was presented, or 0.
+ */
+static Microseconds last_frame_present = 0;
+/**
+ * Whether or not the window is shown and has the keyboard focus, according to
+ * the window events read so far.
+ */
+static int window_is_visible = 1;
+static int window_has_focus = 1;
+/**
+ * Whether or not the game is drawn to the terminal instead of to a renderer.
+ */
+static int terminal_mode = 0;
+/**
+ * The Grid print, clear, and present use in terminal mode.
+ */
+static Grid screen_grid;
 
-void clear(SDL_Renderer *renderer) { SDL_RenderClear(renderer); }
+void clear(SDL_Renderer *renderer) {
+  if (terminal_mode) {
+    clear_grid(&screen_grid, DEFAULT_COLOR);
+  } else {
+    SDL_RenderClear(renderer);
+  }
+}
 
-void present(SDL_Renderer *renderer) { SDL_RenderPresent(renderer); }
+void present(SDL_Renderer *renderer) {
+  if (terminal_mode) {
+    write_grid_to_terminal(&screen_grid);
+  } else {
+    /* Read back the frame before presenting it invalidates the buffer. */
+    capture_frame(renderer);
+    SDL_RenderPresent(renderer);
+  }
+}
 
 /**
  * Initializes the global fonts.
@@ -85,6 +179,63 @@ static SDL_Window *create_window(int width, int height) {
   return SDL_CreateWindow(title, x, y, width, height, flags);
 }
 
+/**
+ * Sets the refresh rate to the one of the display of the provided window.
+ *
+ * Keeps the previous refresh rate if the display does not report one.
+ */
+static void initialize_refresh_rate(SDL_Window *window) {
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  const int display = SDL_GetWindowDisplayIndex(window);
+  SDL_DisplayMode mode;
+  if (display >= 0 && SDL_GetCurrentDisplayMode(display, &mode) == 0 &&
+      mode.refresh_rate > 0) {
+    refresh_rate = mode.refresh_rate;
+  }
+  sprintf(log_buffer, "Drawing at %d frames per second", refresh_rate);
+  log_message(log_buffer);
+}
+
+/**
+ * Returns the flags the renderer of the window is created with.
+ */
+static Uint32 get_renderer_flags(void) {
+  if (get_options()->vsync) {
+    log_message("Presenting in sync with the display");
+    return SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+  }
+  return SDL_RENDERER_ACCELERATED;
+}
+
+/**
+ * Returns how many frames per second the screen shows.
+ *
+ * This is the refresh rate of the display of the window, or FPS when there
+ * is no window.
+ */
+int get_refresh_rate(void) { return refresh_rate; }
+
+/**
+ * Creates a software renderer which draws to an offscreen surface.
+ *
+ * This does not need a display, so it is used in headless mode.
+ */
+static SDL_Renderer *create_headless_renderer(int width, int height) {
+  SDL_Surface *surface;
+  SDL_Renderer *renderer;
+  surface = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
+  if (surface == NULL) {
+    return NULL;
+  }
+  renderer = SDL_CreateSoftwareRenderer(surface);
+  if (renderer == NULL) {
+    SDL_FreeSurface(surface);
+    return NULL;
+  }
+  headless_surface = surface;
+  return renderer;
+}
+
 int set_window_title_and_icon(SDL_Window *window) {
   SDL_SetWindowTitle(window, GAME_NAME);
   SDL_Surface *icon_surface = IMG_Load(ICON_PATH);
@@ -101,6 +252,132 @@ static void set_render_color(SDL_Renderer *renderer, Color color) {
   SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 }
 
+/**
+ * Returns the index of the glyph of a character in the glyph atlas.
+ *
+ * Characters without a glyph in the atlas are mapped to the space.
+ */
+static int atlas_index(const char character) {
+  const unsigned char c = (unsigned char)character;
+  if (c < FIRST_ATLAS_CHARACTER || c > LAST_ATLAS_CHARACTER) {
+    return 0;
+  }
+  return c - FIRST_ATLAS_CHARACTER;
+}
+
+/**
+ * Rasterizes all printable glyphs of the font into a new texture.
+ *
+ * Returns NULL in case of failure.
+ */
+static SDL_Texture *create_atlas_texture(SDL_Renderer *renderer) {
+  const SDL_Color white = to_sdl_color(color_from_rgb(255, 255, 255));
+  const int width = global_monospaced_font_width;
+  const int height = global_monospaced_font_height;
+  TTF_Font *font = global_monospaced_font;
+  SDL_Surface *atlas_surface;
+  SDL_Surface *glyph_surface;
+  SDL_Texture *texture;
+  SDL_Rect source;
+  SDL_Rect destination;
+  int i;
+  atlas_surface = SDL_CreateRGBSurface(0, ATLAS_CHARACTER_COUNT * width,
+                                       height, 32, 0x00FF0000, 0x0000FF00,
+                                       0x000000FF, 0xFF000000);
+  if (atlas_surface == NULL) {
+    log_message("Failed to allocate glyph atlas surface");
+    return NULL;
+  }
+  /* Start fully transparent. */
+  SDL_FillRect(atlas_surface, NULL, 0);
+  source.x = 0;
+  source.y = 0;
+  source.w = width;
+  source.h = height;
+  destination.y = 0;
+  for (i = 0; i < ATLAS_CHARACTER_COUNT; i++) {
+    glyph_surface =
+        TTF_RenderGlyph_Blended(font, FIRST_ATLAS_CHARACTER + i, white);
+    /* Glyphs which cannot be rendered are left transparent. */
+    if (glyph_surface != NULL) {
+      /* Copy the alpha of the glyph instead of blending it with nothing. */
+      SDL_SetSurfaceBlendMode(glyph_surface, SDL_BLENDMODE_NONE);
+      destination.x = i * width;
+      SDL_BlitSurface(glyph_surface, &source, atlas_surface, &destination);
+      SDL_FreeSurface(glyph_surface);
+    }
+  }
+  texture = SDL_CreateTextureFromSurface(renderer, atlas_surface);
+  SDL_FreeSurface(atlas_surface);
+  if (texture == NULL) {
+    log_message("Failed to create glyph atlas texture");
+    return NULL;
+  }
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return texture;
+}
+
+/**
+ * Rasterizes the glyph atlas.
+ *
+ * Returns 0 in case of success.
+ */
+static int initialize_glyph_atlas(SDL_Renderer *renderer) {
+  if (glyph_atlas == NULL) {
+    glyph_atlas = create_atlas_texture(renderer);
+  }
+  return glyph_atlas == NULL;
+}
+
+/**
+ * Copies the glyph with the provided index in the glyph atlas to a rectangle.
+ *
+ * The color modulation of the atlas must have been set to the foreground.
+ */
+static void copy_glyph(const int index, const SDL_Rect *const destination,
+                       SDL_Renderer *renderer) {
+  SDL_Rect source;
+  source.x = index * global_monospaced_font_width;
+  source.y = 0;
+  source.w = global_monospaced_font_width;
+  source.h = global_monospaced_font_height;
+  SDL_RenderCopy(renderer, glyph_atlas, &source, destination);
+}
+
+static void set_glyph_color(const Color color) {
+  SDL_SetTextureColorMod(glyph_atlas, color.r, color.g, color.b);
+}
+
+/**
+ * Initializes the resources required to draw to the terminal.
+ *
+ * Fonts, windows, and renderers are not needed, only the SDL timer is.
+ *
+ * Returns 0 in case of success.
+ */
+static int initialize_terminal_mode(SDL_Window **window,
+                                    SDL_Renderer **renderer) {
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  log_message("Running in terminal mode");
+  if (get_options()->capture_path != NULL) {
+    log_message("Frames cannot be captured in terminal mode");
+  }
+  if (SDL_Init(SDL_INIT_TIMER)) {
+    sprintf(log_buffer, "SDL initialization error: %s", SDL_GetError());
+    log_message(log_buffer);
+    return 1;
+  }
+  *window = NULL;
+  *renderer = NULL;
+  if (initialize_terminal()) {
+    log_message("Failed to initialize the terminal");
+    return 1;
+  }
+  terminal_mode = 1;
+  clear_grid(&screen_grid, DEFAULT_COLOR);
+  return 0;
+}
+
 /**
  * Initializes the required resources.
  *
@@ -113,8 +390,17 @@ int initialize(SDL_Window **window, SDL_Renderer **renderer) {
   SDL_Renderer *rendererSurface = NULL;
   int width = 1;
   int height = 1;
+  const int headless = get_options()->headless;
   initialize_logger();
   initialize_profiler();
+  if (get_options()->terminal) {
+    return initialize_terminal_mode(window, renderer);
+  }
+  if (headless) {
+    /* The dummy video driver works without a display. */
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    log_message("Running in headless mode");
+  }
   /* Initialize SDL. */
   if (SDL_Init(SDL_INIT_VIDEO)) {
     sprintf(log_buffer, "SDL initialization error: %s", SDL_GetError());
@@ -151,25 +437,53 @@ int initialize(SDL_Window **window, SDL_Renderer **renderer) {
    */
   width = global_monospaced_font_width * COLUMNS;
   height = global_monospaced_font_height * LINES;
-  /* Log the size of the window we are going to create. */
-  sprintf(log_buffer, "Creating a %dx%d window", width, height);
-  log_message(log_buffer);
-  *window = create_window(width, height);
-  if (*window == NULL) {
-    sprintf(log_buffer, "SDL initialization error: %s", SDL_GetError());
+  if (headless) {
+    sprintf(log_buffer, "Creating a %dx%d offscreen surface", width, height);
+    log_message(log_buffer);
+    *window = NULL;
+    *renderer = create_headless_renderer(width, height);
+  } else {
+    /* Log the size of the window we are going to create. */
+    sprintf(log_buffer, "Creating a %dx%d window", width, height);
+    log_message(log_buffer);
+    *window = create_window(width, height);
+    if (*window == NULL) {
+      sprintf(log_buffer, "SDL initialization error: %s", SDL_GetError());
+      log_message(log_buffer);
+      return 1;
+    }
+    set_window_title_and_icon(*window);
+    initialize_refresh_rate(*window);
+    *renderer = SDL_CreateRenderer(*window, -1, get_renderer_flags());
+  }
+  if (*renderer == NULL) {
+    sprintf(log_buffer, "SDL renderer creation error: %s", SDL_GetError());
     log_message(log_buffer);
     return 1;
   }
-  set_window_title_and_icon(*window);
-  *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED);
   set_render_color(*renderer, BACKGROUND_COLOR);
   clear(*renderer);
+  if (initialize_glyph_atlas(*renderer)) {
+    sprintf(log_buffer, "Failed to initialize the glyph atlas");
+    log_message(log_buffer);
+    return 1;
+  }
+  if (get_options()->capture_path != NULL) {
+    /* Games present at the refresh rate, so the video plays at it. */
+    if (initialize_capture(get_options()->capture_path, width, height,
+                           get_refresh_rate())) {
+      return 1;
+    }
+  }
   return 0;
 }
 
 static void finalize_cached_textures(void) {
-  SDL_DestroyTexture(borders_texture);
-  borders_texture = NULL;
+  SDL_DestroyTexture(grid_texture);
+  grid_texture = NULL;
+  rendered_grid_is_valid = 0;
+  SDL_DestroyTexture(glyph_atlas);
+  glyph_atlas = NULL;
 }
 
 /**
@@ -190,10 +504,22 @@ static void finalize_fonts(void) {
  * Returns 0 in case of success.
  */
 int finalize(SDL_Window **window, SDL_Renderer **renderer) {
+  finalize_capture();
   finalize_cached_textures();
   finalize_fonts();
-  SDL_DestroyWindow(*window);
+  if (terminal_mode) {
+    finalize_terminal();
+    terminal_mode = 0;
+  } else if (headless_surface != NULL) {
+    /* Without a window, the renderer must be destroyed explicitly. */
+    SDL_DestroyRenderer(*renderer);
+    SDL_FreeSurface(headless_surface);
+    headless_surface = NULL;
+  } else {
+    SDL_DestroyWindow(*window);
+  }
   *window = NULL;
+  *renderer = NULL;
   if (TTF_WasInit()) {
     TTF_Quit();
   }
@@ -207,7 +533,7 @@ int finalize(SDL_Window **window, SDL_Renderer **renderer) {
  * Initializes the color schemes used to render the game.
  */
 int initialize_color_schemes(void) {
-  /* Nothing to do for now. */
+  /* The glyph atlas serves every ColorPair, so nothing is rasterized. */
   return 0;
 }
 
@@ -261,14 +587,9 @@ void read_player_name(char *destination, const size_t maximum_size,
  */
 int print(const int x, const int y, const char *string,
           const ColorPair color_pair, SDL_Renderer *renderer) {
-  const SDL_Color foreground = to_sdl_color(color_pair.foreground);
-  const SDL_Color background = to_sdl_color(color_pair.background);
-  TTF_Font *font = global_monospaced_font;
-  SDL_Surface *surface;
-  SDL_Texture *texture;
+  SDL_Rect background;
   SDL_Rect position;
-  position.x = global_monospaced_font_width * x;
-  position.y = global_monospaced_font_height * y;
+  size_t i;
   if (string == NULL || string[0] == '\0') {
     return 0;
   }
@@ -276,21 +597,25 @@ int print(const int x, const int y, const char *string,
   if (x < 0 || y < 0) {
     return 1;
   }
-  surface = TTF_RenderText_Shaded(font, string, foreground, background);
-  if (surface == NULL) {
-    log_message("Failed to allocate text surface in print()");
-    return 1;
+  if (terminal_mode) {
+    write_string_to_grid(&screen_grid, x, y, string, color_pair);
+    return 0;
   }
-  texture = SDL_CreateTextureFromSurface(renderer, surface);
-  if (texture == NULL) {
-    log_message("Failed to create texture from surface in print()");
-    return 1;
+  position.x = global_monospaced_font_width * x;
+  position.y = global_monospaced_font_height * y;
+  position.w = global_monospaced_font_width;
+  position.h = global_monospaced_font_height;
+  background = position;
+  background.w = strlen(string) * global_monospaced_font_width;
+  set_render_color(renderer, color_pair.background);
+  SDL_RenderFillRect(renderer, &background);
+  set_render_color(renderer, BACKGROUND_COLOR);
+  /* Copy each glyph from the atlas instead of rasterizing the string. */
+  set_glyph_color(color_pair.foreground);
+  for (i = 0; string[i] != '\0'; i++) {
+    copy_glyph(atlas_index(string[i]), &position, renderer);
+    position.x += global_monospaced_font_width;
   }
-  /* Copy destination width and height from the texture. */
-  SDL_QueryTexture(texture, NULL, NULL, &position.w, &position.h);
-  SDL_RenderCopy(renderer, texture, NULL, &position);
-  SDL_DestroyTexture(texture);
-  SDL_FreeSurface(surface);
   return 0;
 }
 
@@ -299,93 +624,135 @@ static SDL_Texture *renderable_texture(int w, int h, SDL_Renderer *renderer) {
   return SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, access, w, h);
 }
 
-static Code cache_borders_texture(BoundingBox borders, SDL_Renderer *renderer) {
-  const SDL_Color foreground = to_sdl_color(DEFAULT_COLOR.foreground);
-  const SDL_Color background = to_sdl_color(DEFAULT_COLOR.background);
-  const int x_step = global_monospaced_font_width;
-  const int y_step = global_monospaced_font_height;
-  const int min_x = borders.min_x;
-  const int max_x = borders.max_x;
-  const int min_y = borders.min_y;
-  const int max_y = borders.max_y;
-  const int full_width = (max_x - min_x + 1) * x_step;
-  const int full_height = (max_y - min_y + 1) * y_step;
-  SDL_Surface *surface;
-  SDL_Texture *glyph_texture;
-  SDL_Texture *full_texture;
-  SDL_Rect position;
-  TTF_Font *font = global_monospaced_font;
+static SDL_Rect rect_from_render_command(const RenderCommand *const command) {
+  SDL_Rect rect;
+  rect.x = command->x * global_monospaced_font_width;
+  rect.y = command->y * global_monospaced_font_height;
+  rect.w = command->w * global_monospaced_font_width;
+  rect.h = command->h * global_monospaced_font_height;
+  return rect;
+}
+
+/**
+ * Submits count fill commands, which must all have the same color, with a
+ * single draw call.
+ */
+static void submit_fill_commands(const RenderCommand *commands,
+                                 const size_t count, SDL_Renderer *renderer) {
+  size_t i;
+  for (i = 0; i < count; i++) {
+    fill_rects[i] = rect_from_render_command(commands + i);
+  }
+  set_render_color(renderer, commands[0].color_pair.background);
+  SDL_RenderFillRects(renderer, fill_rects, count);
+  /* Clearing uses the draw color, so restore it. */
+  set_render_color(renderer, BACKGROUND_COLOR);
+}
+
+static void submit_glyph_command(const RenderCommand *const command,
+                                 SDL_Renderer *renderer) {
+  const SDL_Rect destination = rect_from_render_command(command);
+  set_glyph_color(command->color_pair.foreground);
+  copy_glyph(command->glyph, &destination, renderer);
+}
+
+/**
+ * Sorts, merges, and submits the provided RenderCommands to the current
+ * render target.
+ *
+ * Flushing does not clear the buffer, so flushing it again replays the frame.
+ *
+ * Returns the number of draw calls issued.
+ */
+int flush_render_commands(RenderCommandBuffer *const buffer,
+                          SDL_Renderer *renderer) {
+  const RenderCommand *commands = buffer->commands;
+  const Color *color;
+  int draw_calls = 0;
+  size_t begin = 0;
+  size_t end;
+  sort_and_merge_render_commands(buffer);
+  while (begin < buffer->count) {
+    if (commands[begin].kind == RENDER_COMMAND_FILL) {
+      /* Find the end of the run of fills with the same color. */
+      color = &commands[begin].color_pair.background;
+      end = begin + 1;
+      while (end < buffer->count && commands[end].kind == RENDER_COMMAND_FILL &&
+             color_equals(commands[end].color_pair.background, *color)) {
+        end++;
+      }
+      submit_fill_commands(commands + begin, end - begin, renderer);
+    } else {
+      submit_glyph_command(commands + begin, renderer);
+      end = begin + 1;
+    }
+    draw_calls++;
+    begin = end;
+  }
+  return draw_calls;
+}
+
+/**
+ * Returns the RenderCommands of the last frame drawn by draw_game.
+ */
+RenderCommandBuffer *get_frame_render_commands(void) { return &frame_commands; }
+
+/**
+ * Appends the commands needed to render the Cells of the Grid which changed
+ * since the last call to the provided buffer.
+ *
+ * Every Cell becomes a fill command and Cells which are not blank also become
+ * a glyph command, drawn over the fill.
+ */
+static void append_grid_changes(const Grid *const grid,
+                                RenderCommandBuffer *const buffer) {
+  Cell cell;
   int x;
   int y;
-  if (borders_texture != NULL) {
-    return CODE_ERROR;
-  }
-  if (min_x < 0 || min_y < 0 || min_x > max_x || min_y > max_y) {
-    log_message("Got invalid border limits");
-    return CODE_ERROR;
-  }
-  /* All preconditions are valid. */
-  /* Now we create a texture for a single glyph. */
-  surface = TTF_RenderGlyph_Shaded(font, '+', foreground, background);
-  glyph_texture = SDL_CreateTextureFromSurface(renderer, surface);
-  /* Free surface now because we may return before the end. */
-  SDL_FreeSurface(surface);
-  /* Create the target texture. */
-  full_texture = renderable_texture(full_width, full_height, renderer);
-  if (!full_texture) {
-    log_message("Failed to create cached borders texture");
-    return CODE_ERROR;
-  }
-  /* Change the renderer target to the texture which will be cached. */
-  SDL_SetRenderTarget(renderer, full_texture);
-  SDL_RenderClear(renderer);
-  /* Copy destination width and height from the texture. */
-  SDL_QueryTexture(glyph_texture, NULL, NULL, &position.w, &position.h);
-  /*
-   * This is the optimized step.
-   *
-   * We have a texture of a single symbol, so we just copy it to all the places
-   * where the symbol should appear.
-   */
-  /* Write the top and bottom borders. */
-  for (x = 0; x < full_width; x += x_step) {
-    position.x = x;
-    position.y = 0;
-    SDL_RenderCopy(renderer, glyph_texture, NULL, &position);
-    position.y = full_height - y_step;
-    SDL_RenderCopy(renderer, glyph_texture, NULL, &position);
-  }
-  /* Write the left and right borders. */
-  for (y = 0; y < full_height; y += y_step) {
-    position.y = y;
-    position.x = 0;
-    SDL_RenderCopy(renderer, glyph_texture, NULL, &position);
-    position.x = full_width - x_step;
-    SDL_RenderCopy(renderer, glyph_texture, NULL, &position);
-  }
-  /* Change the renderer target back to the window. */
-  SDL_DestroyTexture(glyph_texture);
-  SDL_SetRenderTarget(renderer, NULL);
-  /* Note that the texture is not destroyed here (obviosly). */
-  borders_texture = full_texture;
-  return CODE_OK;
+  for (y = 0; y < LINES; y++) {
+    for (x = 0; x < COLUMNS; x++) {
+      cell = grid->cells[y][x];
+      if (rendered_grid_is_valid &&
+          cell_equals(cell, rendered_grid.cells[y][x])) {
+        continue;
+      }
+      rendered_grid.cells[y][x] = cell;
+      append_fill_command(buffer, x, y, 1, cell.color_pair);
+      if (cell.glyph != ' ') {
+        append_glyph_command(buffer, x, y, atlas_index(cell.glyph),
+                             cell.color_pair);
+      }
+    }
+  }
+  rendered_grid_is_valid = 1;
 }
 
-static Code render_borders(BoundingBox borders, SDL_Renderer *renderer) {
-  const int x_step = global_monospaced_font_width;
-  const int y_step = global_monospaced_font_height;
-  SDL_Rect pos;
-  pos.x = borders.min_x * x_step;
-  pos.y = borders.min_y * y_step;
-  if (borders_texture == NULL) {
-    cache_borders_texture(borders, renderer);
-    if (borders_texture == NULL) {
-      /* Failed to cache the texture. */
+/**
+ * Renders the provided Grid to the screen.
+ *
+ * Only the Cells which changed since the last call are rendered to the grid
+ * texture, which is then copied to the screen.
+ */
+static Code render_grid(const Grid *const grid, SDL_Renderer *renderer) {
+  const int width = COLUMNS * global_monospaced_font_width;
+  const int height = LINES * global_monospaced_font_height;
+  int draw_calls;
+  if (grid_texture == NULL) {
+    grid_texture = renderable_texture(width, height, renderer);
+    if (grid_texture == NULL) {
+      log_message("Failed to create the grid texture");
       return CODE_ERROR;
     }
+    rendered_grid_is_valid = 0;
   }
-  SDL_QueryTexture(borders_texture, NULL, NULL, &pos.w, &pos.h);
-  SDL_RenderCopy(renderer, borders_texture, NULL, &pos);
+  clear_render_commands(&frame_commands);
+  append_grid_changes(grid, &frame_commands);
+  SDL_SetRenderTarget(renderer, grid_texture);
+  draw_calls = flush_render_commands(&frame_commands, renderer);
+  SDL_SetRenderTarget(renderer, NULL);
+  SDL_RenderCopy(renderer, grid_texture, NULL, NULL);
+  /* Copying the grid texture to the screen is one more draw call. */
+  update_profiler_count_histogram("render_grid:draw_calls", draw_calls + 1);
   return CODE_OK;
 }
 
@@ -460,127 +827,52 @@ void print_long_text(char *string, SDL_Renderer *renderer) {
   present(renderer);
 }
 
-void write_top_bar_strings(char *strings[], SDL_Renderer *renderer) {
-  int begin_x;
-  int after_x;
-  int begin_text_x;
-  int after_text_x;
-
-  int string_length;
-
-  int x;
-  int i;
-
-  const int columns_per_string = COLUMNS / TOP_BAR_STRING_COUNT;
-
-  char buffer[COLUMNS + 1];
-  memset(buffer, ' ', COLUMNS);
-  buffer[COLUMNS] = '\0';
-
-  for (i = 0; i < TOP_BAR_STRING_COUNT; i++) {
-    begin_x = i * columns_per_string;
-    after_x = (i + 1) * columns_per_string;
-    if (i + 1 == TOP_BAR_STRING_COUNT) {
-      /*
-       * If this is the last string on the top, make sure that we will
-       * write enough colored spaces. Integer division truncates, which
-       * can make 4 * (COLUMNS / 4) != COLUMNS. Therefore, some spaces may be
-       * left uncolored at the end if we do not ensure that all columns
-       * are painted.
-       */
-      after_x = COLUMNS;
-    }
-    string_length = strlen(strings[i]);
-    if (string_length < columns_per_string) {
-      /*
-       * Write the string because it fits.
-       */
-      begin_text_x = begin_x + (columns_per_string - string_length) / 2;
-      after_text_x = begin_text_x + string_length;
-      for (x = begin_x; x < begin_text_x; x++) {
-        buffer[x] = ' ';
-      }
-      copy_string(buffer + x, strings[i], COLUMNS + 1 - x);
-      for (x = after_text_x; x < after_x; x++) {
-        buffer[x] = ' ';
-      }
-    } else {
-      /*
-       * String does not fit, do not write it.
-       */
-      for (x = begin_x; x < after_x; x++) {
-        buffer[x] = ' ';
-      }
-    }
-  }
-  print(0, 0, buffer, TOP_BAR_COLOR, renderer);
-}
-
 /**
- * Draws the top status bar on the screen for a given Player.
- *
- * Returns 0 if successful.
+ * Draws the borders around the provided BoundingBox.
  */
-int draw_top_bar(const Player *const player, SDL_Renderer *renderer) {
-  char power_buffer[MAXIMUM_STRING_SIZE];
-  char lives_buffer[MAXIMUM_STRING_SIZE];
-  char score_buffer[MAXIMUM_STRING_SIZE];
-
-  char *strings[TOP_BAR_STRING_COUNT];
-
-  if (player->perk != PERK_NONE) {
-    sprintf(power_buffer, "%s", get_perk_name(player->perk));
-  } else {
-    sprintf(power_buffer, "No Power");
-  }
-
-  sprintf(lives_buffer, "Lives: %d", player->lives);
-
-  sprintf(score_buffer, "Score: %d", player->score);
-
-  strings[0] = GAME_NAME;
-  strings[1] = power_buffer;
-  strings[2] = lives_buffer;
-  strings[3] = score_buffer;
-
-  write_top_bar_strings(strings, renderer);
-  return 0;
-}
-
-/*
- * Draws the bottom status bar on the screen for a given Player.
- */
-void draw_bottom_bar(const char *message, SDL_Renderer *renderer) {
+void draw_borders(const BoundingBox *const box, Grid *const grid) {
+  const int min_x = box->min_x - 1;
+  const int max_x = box->max_x + 1;
+  const int min_y = box->min_y - 1;
+  const int max_y = box->max_y + 1;
   char buffer[COLUMNS + 1];
-  memset(buffer, ' ', COLUMNS);
-  buffer[COLUMNS] = '\0';
-  print(0, LINES - 1, buffer, BOTTOM_BAR_COLOR, renderer);
-  print(0, LINES - 1, message, BOTTOM_BAR_COLOR, renderer);
+  int width = max_x - min_x + 1;
+  int y;
+  width = max(0, min(width, COLUMNS));
+  memset(buffer, '+', width);
+  buffer[width] = '\0';
+  write_string_to_grid(grid, min_x, min_y, buffer, DEFAULT_COLOR);
+  write_string_to_grid(grid, min_x, max_y, buffer, DEFAULT_COLOR);
+  for (y = min_y + 1; y < max_y; y++) {
+    write_string_to_grid(grid, min_x, y, "+", DEFAULT_COLOR);
+    write_string_to_grid(grid, max_x, y, "+", DEFAULT_COLOR);
+  }
 }
 
 /**
- * Draws the borders of the screen.
+ * Builds the layer of everything that does not change during a Game.
+ *
+ * This is the background, the backgrounds of the bars, the name of the game,
+ * and the borders around the provided BoundingBox.
  */
-void draw_borders(SDL_Renderer *renderer) {
-  BoundingBox borders;
-  borders.min_x = 0;
-  borders.max_x = COLUMNS - 1;
-  borders.min_y = 1;
-  borders.max_y = LINES - 2;
-  render_borders(borders, renderer);
+void cache_static_layer(const BoundingBox *const box) {
+  clear_grid(&static_layer, DEFAULT_COLOR);
+  fill_grid_span(&static_layer, 0, 0, COLUMNS, TOP_BAR_COLOR);
+  write_top_bar_string(static_layer.cells[0], 0, GAME_NAME);
+  fill_grid_span(&static_layer, 0, LINES - 1, COLUMNS, BOTTOM_BAR_COLOR);
+  draw_borders(box, &static_layer);
+  static_layer_box = *box;
+  static_layer_is_valid = 1;
+  /* The bars of the Hud are built on top of the static layer. */
+  invalidate_hud(&hud);
 }
 
 int draw_platforms(const Platform *platforms, const size_t platform_count,
-                   const BoundingBox *const box, SDL_Renderer *renderer) {
+                   const BoundingBox *const box, Grid *const grid) {
   int y;
   int min_x;
   int max_x;
   size_t i;
-  /* We make the assumption that the biggest box is COLUMNS wide. */
-  char buffer[COLUMNS + 1];
-  char *iter;
-  memset(buffer, ' ', COLUMNS + 1);
-  buffer[COLUMNS] = '\0';
   for (i = 0; i < platform_count; i++) {
     y = platforms[i].y;
     min_x = platforms[i].x;
@@ -589,75 +881,214 @@ int draw_platforms(const Platform *platforms, const size_t platform_count,
       if (min_x <= box->max_x && max_x >= box->min_x) {
         min_x = max(box->min_x, min_x);
         max_x = min(box->max_x, max_x);
-        iter = buffer + COLUMNS - (max_x - min_x + 1);
-        print(min_x, y, iter, PLATFORM_COLOR, renderer);
+        fill_grid_span(grid, min_x, y, max_x - min_x + 1, PLATFORM_COLOR);
       }
     }
   }
   return 0;
 }
 
-int has_active_perk(const Game *const game) { return game->perk != PERK_NONE; }
-
 ColorPair get_perk_color(Perk perk) { return PERK_COLOR; }
 
-int draw_perk(const Game *const game, SDL_Renderer *renderer) {
+int draw_perk(const Snapshot *const snapshot, Grid *const grid) {
+  const int x = snapshot->perk_x;
+  const int y = snapshot->perk_y;
   ColorPair perk_color;
-  if (has_active_perk(game)) {
-    perk_color = get_perk_color(game->perk);
-    print(game->perk_x, game->perk_y, get_perk_symbol(), perk_color, renderer);
+  if (snapshot->perk != PERK_NONE) {
+    perk_color = get_perk_color(snapshot->perk);
+    write_string_to_grid(grid, x, y, get_perk_symbol(), perk_color);
   }
   return 0;
 }
 
-int draw_player(const Player *const player, SDL_Renderer *renderer) {
-  print(player->x, player->y, PLAYER_SYMBOL, DEFAULT_COLOR, renderer);
+int draw_player(const Player *const player, Grid *const grid) {
+  write_string_to_grid(grid, player->x, player->y, PLAYER_SYMBOL,
+                       DEFAULT_COLOR);
   return 0;
 }
 
 /**
- * Draws a full game to the screen.
+ * Converts an interpolated coordinate, in cells, to the nearest pixel.
  */
-int draw_game(const Game *const game, SDL_Renderer *renderer) {
+static int to_pixels(const double coordinate, const int cell_size) {
+  const double pixels = coordinate * cell_size;
+  return (int)(pixels < 0.0 ? pixels - 0.5 : pixels + 0.5);
+}
+
+/**
+ * Draws the platforms of the Snapshots over the screen, at their positions
+ * interpolated by alpha, with a single draw call.
+ */
+static void draw_moving_platforms(const Snapshot *const previous,
+                                  const Snapshot *const current,
+                                  const double alpha, SDL_Renderer *renderer) {
+  const int width = global_monospaced_font_width;
+  const int height = global_monospaced_font_height;
+  const BoundingBox *const box = &current->box;
+  const int min_x = box->min_x * width;
+  const int max_x = (box->max_x + 1) * width;
+  const Platform *platform;
+  double x;
+  double y;
+  int left;
+  int right;
+  int count = 0;
+  size_t i;
+  for (i = 0; i < current->platform_count; i++) {
+    platform = current->platforms + i;
+    if (platform->y < box->min_y || platform->y > box->max_y) {
+      continue;
+    }
+    x = platform->x;
+    y = platform->y;
+    if (i < previous->platform_count) {
+      x = interpolate_coordinate(previous->platforms[i].x, platform->x, alpha);
+      y = interpolate_coordinate(previous->platforms[i].y, platform->y, alpha);
+    }
+    /* Clip the platform to the box, as draw_platforms does. */
+    left = max(to_pixels(x, width), min_x);
+    right = min(to_pixels(x + platform->width, width), max_x);
+    if (left < right) {
+      fill_rects[count].x = left;
+      fill_rects[count].y = to_pixels(y, height);
+      fill_rects[count].w = right - left;
+      fill_rects[count].h = height;
+      count++;
+    }
+  }
+  set_render_color(renderer, PLATFORM_COLOR.background);
+  SDL_RenderFillRects(renderer, fill_rects, count);
+  set_render_color(renderer, BACKGROUND_COLOR);
+}
+
+/**
+ * Draws the Player of the Snapshots over the screen, at its position
+ * interpolated by alpha, on the background of a Cell of DEFAULT_COLOR.
+ */
+static void draw_moving_player(const Snapshot *const previous,
+                               const Snapshot *const current,
+                               const double alpha, SDL_Renderer *renderer) {
+  const Player *const from = &previous->player;
+  const Player *const to = &current->player;
+  SDL_Rect position;
+  position.x = to_pixels(interpolate_coordinate(from->x, to->x, alpha),
+                         global_monospaced_font_width);
+  position.y = to_pixels(interpolate_coordinate(from->y, to->y, alpha),
+                         global_monospaced_font_height);
+  position.w = global_monospaced_font_width;
+  position.h = global_monospaced_font_height;
+  set_render_color(renderer, DEFAULT_COLOR.background);
+  SDL_RenderFillRect(renderer, &position);
+  set_render_color(renderer, BACKGROUND_COLOR);
+  set_glyph_color(DEFAULT_COLOR.foreground);
+  copy_glyph(atlas_index(PLAYER_SYMBOL[0]), &position, renderer);
+}
+
+/**
+ * Presents a frame of a game and records how well frames are paced.
+ *
+ * Records how long the present blocked, how many vblanks were missed since
+ * the previous frame, and how far the interval between the two frames was
+ * from a whole number of refresh periods.
+ */
+static void present_frame(SDL_Renderer *renderer) {
+  const Microseconds refresh_period = MICROSECONDS_IN_ONE_SECOND / refresh_rate;
+  const Microseconds start = get_microseconds();
+  Microseconds end;
+  Microseconds interval;
+  Microseconds periods;
+  Microseconds jitter;
+  present(renderer);
+  end = get_microseconds();
+  update_profiler("draw_game:present", (end - start) / 1000);
+  update_profiler_microsecond_histogram("present:blocked", end - start);
+  interval = end - last_frame_present;
+  if (last_frame_present != 0 && interval <= MAXIMUM_PACED_INTERVAL) {
+    periods = (interval + refresh_period / 2) / refresh_period;
+    if (interval > periods * refresh_period) {
+      jitter = interval - periods * refresh_period;
+    } else {
+      jitter = periods * refresh_period - interval;
+    }
+    update_profiler_count_histogram("present:missed_vblanks",
+                                    periods > 1 ? periods - 1 : 0);
+    update_profiler_microsecond_histogram("present:jitter", jitter);
+  }
+  last_frame_present = end;
+}
+
+/**
+ * Draws a game between two Snapshots to the screen.
+ *
+ * Alpha, in [0, 1], is how much time passed from the previous Snapshot to the
+ * current one. The platforms and the Player are drawn over the grid at their
+ * interpolated positions. The terminal can only show whole cells, so there
+ * the current Snapshot is drawn.
+ */
+int draw_snapshots(const Snapshot *const previous,
+                   const Snapshot *const current, const double alpha,
+                   SDL_Renderer *renderer) {
+  const BoundingBox *const box = &current->box;
   Milliseconds draw_game_start = get_milliseconds();
   Milliseconds start;
 
   start = get_milliseconds();
-  clear(renderer);
-  update_profiler("draw_game:clear", get_milliseconds() - start);
+  if (!static_layer_is_valid || !bounding_box_equals(&static_layer_box, box)) {
+    cache_static_layer(box);
+  }
+  back_grid = static_layer;
+  update_profiler("draw_game:static_layer", get_milliseconds() - start);
 
   start = get_milliseconds();
-  draw_top_bar(game->player, renderer);
-  update_profiler("draw_game:draw_top_bar", get_milliseconds() - start);
+  update_hud(&hud, &current->player, current->message, &static_layer);
+  draw_hud(&hud, &back_grid);
+  update_profiler("draw_game:draw_hud", get_milliseconds() - start);
 
   start = get_milliseconds();
-  draw_bottom_bar(game->message, renderer);
-  update_profiler("draw_game:draw_bottom_bar", get_milliseconds() - start);
+  draw_perk(current, &back_grid);
+  update_profiler("draw_game:draw_perk", get_milliseconds() - start);
 
-  start = get_milliseconds();
-  draw_borders(renderer);
-  update_profiler("draw_game:draw_borders", get_milliseconds() - start);
+  if (terminal_mode) {
+    start = get_milliseconds();
+    draw_platforms(current->platforms, current->platform_count, box,
+                   &back_grid);
+    update_profiler("draw_game:draw_platforms", get_milliseconds() - start);
 
-  start = get_milliseconds();
-  draw_platforms(game->platforms, game->platform_count, game->box, renderer);
-  update_profiler("draw_game:draw_platforms", get_milliseconds() - start);
+    start = get_milliseconds();
+    draw_player(&current->player, &back_grid);
+    update_profiler("draw_game:draw_player", get_milliseconds() - start);
 
-  start = get_milliseconds();
-  draw_perk(game, renderer);
-  update_profiler("draw_game:draw_perk", get_milliseconds() - start);
+    /* The terminal shows the changes as soon as they are written. */
+    start = get_milliseconds();
+    write_grid_to_terminal(&back_grid);
+    update_profiler("draw_game:write_terminal", get_milliseconds() - start);
+  } else {
+    start = get_milliseconds();
+    render_grid(&back_grid, renderer);
+    update_profiler("draw_game:render_grid", get_milliseconds() - start);
 
-  start = get_milliseconds();
-  draw_player(game->player, renderer);
-  update_profiler("draw_game:draw_player", get_milliseconds() - start);
+    start = get_milliseconds();
+    draw_moving_platforms(previous, current, alpha, renderer);
+    draw_moving_player(previous, current, alpha, renderer);
+    update_profiler("draw_game:moving_objects", get_milliseconds() - start);
 
-  start = get_milliseconds();
-  present(renderer);
-  update_profiler("draw_game:present", get_milliseconds() - start);
+    present_frame(renderer);
+  }
 
   update_profiler("draw_game", get_milliseconds() - draw_game_start);
   return 0;
 }
 
+/**
+ * Draws a full game to the screen.
+ */
+int draw_game(const Game *const game, SDL_Renderer *renderer) {
+  /* Kept between calls, so that its Platforms are only allocated once. */
+  static Snapshot snapshot;
+  take_snapshot(game, &snapshot);
+  return draw_snapshots(&snapshot, &snapshot, 1.0, renderer);
+}
+
 void print_game_result(const char *name, const unsigned int score,
                        const int position, SDL_Renderer *renderer) {
   char first_line[MAXIMUM_STRING_SIZE];
@@ -754,6 +1185,35 @@ static void print_limited(const int x, const int y, const char *string,
   print(x + ELLIPSIS_LENGTH, y, string, DEFAULT_COLOR, renderer);
 }
 
+/**
+ * Updates the state of the window according to the provided event.
+ */
+static void update_window_state(const SDL_Event *const event) {
+  if (event->type != SDL_WINDOWEVENT) {
+    return;
+  }
+  switch (event->window.event) {
+  case SDL_WINDOWEVENT_HIDDEN:
+  case SDL_WINDOWEVENT_MINIMIZED:
+    window_is_visible = 0;
+    break;
+  case SDL_WINDOWEVENT_SHOWN:
+  case SDL_WINDOWEVENT_EXPOSED:
+  case SDL_WINDOWEVENT_RESTORED:
+  case SDL_WINDOWEVENT_MAXIMIZED:
+    window_is_visible = 1;
+    break;
+  case SDL_WINDOWEVENT_FOCUS_LOST:
+    window_has_focus = 0;
+    break;
+  case SDL_WINDOWEVENT_FOCUS_GAINED:
+    window_has_focus = 1;
+    break;
+  default:
+    break;
+  }
+}
+
 /**
  * Reads a string from the user of up to size characters (including NUL).
  *
@@ -772,6 +1232,7 @@ int read_string(const int x, const int y, const char *prompt, char *destination,
   size_t written = strlen(destination);
   char character = '\0';
   char *write = destination + written;
+  int byte;
   SDL_Event event;
   /* Start listening for text input. */
   SDL_StartTextInput();
@@ -796,7 +1257,26 @@ int read_string(const int x, const int y, const char *prompt, char *destination,
       should_rerender = 0;
     }
     /* Throughout the loop, the write pointer always points to a '\0'. */
-    if (SDL_WaitEvent(&event)) {
+    if (terminal_mode) {
+      byte = wait_for_terminal_byte(-1);
+      if (byte == TERMINAL_INTERRUPT) {
+        return 1;
+      } else if ((byte == '\b' || byte == 127) && written > 0) {
+        write--;
+        *write = '\0';
+        written--;
+        should_rerender = 1;
+      } else if (byte == '\r' || byte == '\n') {
+        is_done = 1;
+      } else if (is_valid_input_character(byte) && written + 1 < size) {
+        *write = (char)byte;
+        write++;
+        written++;
+        *write = '\0';
+        should_rerender = 1;
+      }
+    } else if (SDL_WaitEvent(&event)) {
+      update_window_state(&event);
       /* Check for user quit and return 1. */
       /* This is OK because the destination string is always a valid C string.
        */
@@ -846,7 +1326,11 @@ Command read_next_command(void) {
   Command last_valid_command = COMMAND_NONE;
   Command current;
   SDL_Event event;
+  if (terminal_mode) {
+    return read_terminal_command();
+  }
   while (SDL_PollEvent(&event)) {
+    update_window_state(&event);
     current = command_from_event(event);
     if (current != COMMAND_NONE) {
       last_valid_command = current;
@@ -855,31 +1339,144 @@ Command read_next_command(void) {
   return last_valid_command;
 }
 
+/**
+ * Evaluates whether or not the window is shown and has the keyboard focus.
+ *
+ * The terminal is always considered active.
+ */
+int is_window_active(void) {
+  return terminal_mode || (window_is_visible && window_has_focus);
+}
+
+/**
+ * Blocks until the window is shown and has the keyboard focus again.
+ *
+ * Commands issued meanwhile are discarded.
+ *
+ * Returns CODE_QUIT if the user quit.
+ */
+Code wait_for_active_window(void) {
+  SDL_Event event;
+  while (!is_window_active()) {
+    if (!SDL_WaitEvent(&event)) {
+      /* WaitEvent returns 0 to indicate errors. */
+      return CODE_ERROR;
+    }
+    if (event.type == SDL_QUIT) {
+      return CODE_QUIT;
+    }
+    update_window_state(&event);
+  }
+  return CODE_OK;
+}
+
+/**
+ * Appends all pending Commands to the queue, in the order they were issued.
+ *
+ * COMMAND_QUIT is not queued, so that it cannot be dropped.
+ *
+ * Returns CODE_QUIT if the user quit.
+ */
+Code read_commands(CommandQueue *const queue) {
+  Code code = CODE_OK;
+  TimedCommand command;
+  SDL_Event event;
+  if (terminal_mode) {
+    /* The terminal does not tell when a key was pressed. */
+    command.timestamp = get_milliseconds();
+    while ((command.command = read_next_terminal_command()) != COMMAND_NONE) {
+      if (command.command == COMMAND_QUIT) {
+        code = CODE_QUIT;
+      } else {
+        push_command(queue, command);
+      }
+    }
+    return code;
+  }
+  while (SDL_PollEvent(&event)) {
+    update_window_state(&event);
+    command.command = command_from_event(event);
+    command.timestamp = event.common.timestamp;
+    if (command.command == COMMAND_QUIT) {
+      code = CODE_QUIT;
+    } else if (command.command != COMMAND_NONE) {
+      push_command(queue, command);
+    }
+  }
+  return code;
+}
+
+/**
+ * Evaluates whether or not the provided event means that the window has to be
+ * drawn again.
+ */
+static int is_redraw_event(const SDL_Event *const event) {
+  if (event->type != SDL_WINDOWEVENT) {
+    return 0;
+  }
+  switch (event->window.event) {
+  case SDL_WINDOWEVENT_SHOWN:
+  case SDL_WINDOWEVENT_EXPOSED:
+  case SDL_WINDOWEVENT_SIZE_CHANGED:
+  case SDL_WINDOWEVENT_RESTORED:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
 /**
  * Waits for the next command, blocking indefinitely.
+ *
+ * Returns COMMAND_NONE if the window has to be drawn again.
  */
 Command wait_for_next_command(void) {
-  Command command = COMMAND_NONE;
-  while (command == COMMAND_NONE) {
-    rest_for_second_fraction(FPS);
-    command = read_next_command();
+  Command command;
+  SDL_Event event;
+  if (terminal_mode) {
+    return wait_for_terminal_command();
+  }
+  while (SDL_WaitEvent(&event)) {
+    update_window_state(&event);
+    if (is_redraw_event(&event)) {
+      return COMMAND_NONE;
+    }
+    command = command_from_event(event);
+    if (command != COMMAND_NONE) {
+      return command;
+    }
   }
-  return command;
+  /* WaitEvent returns 0 to indicate errors. */
+  return COMMAND_QUIT;
 }
 
 /**
  * Waits for any user input, blocking indefinitely.
+ *
+ * Returns CODE_REDRAW if the window has to be drawn again.
  */
 Code wait_for_input(void) {
   SDL_Event event;
+  int byte;
+  if (terminal_mode) {
+    byte = wait_for_terminal_byte(-1);
+    if (byte == TERMINAL_INTERRUPT) {
+      return CODE_QUIT;
+    }
+    return byte == TERMINAL_NO_INPUT ? CODE_ERROR : CODE_OK;
+  }
   while (1) {
     if (SDL_WaitEvent(&event)) {
+      update_window_state(&event);
       if (event.type == SDL_QUIT) {
         return CODE_QUIT;
       }
       if (event.type == SDL_KEYDOWN) {
         return CODE_OK;
       }
+      if (is_redraw_event(&event)) {
+        return CODE_REDRAW;
+      }
     } else {
       /* WaitEvent returns 0 to indicate errors. */
       return CODE_ERROR;
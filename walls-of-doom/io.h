@@ -7,6 +7,10 @@
 #include "game.h"
 #include "perk.h"
 #include "physics.h"
+#include "render.h"
+#include "snapshot.h"
+
+void clear(SDL_Renderer *renderer);
 
 void present(SDL_Renderer *renderer);
 
@@ -42,11 +46,57 @@ int read_string(const int x, const int y, const char *prompt, char *destination,
 void read_player_name(char *destination, const size_t maximum_size,
                       SDL_Renderer *renderer);
 
+/**
+ * Builds the layer of everything that does not change during a Game.
+ *
+ * This should be called whenever a new Game is created. draw_game rebuilds the
+ * layer if the BoundingBox of the Game is not the one it was built for.
+ */
+void cache_static_layer(const BoundingBox *const box);
+
 /**
  * Draws a full game to the screen.
  */
 int draw_game(const Game *const game, SDL_Renderer *renderer);
 
+/**
+ * Draws a game between two Snapshots to the screen.
+ *
+ * Alpha, in [0, 1], is how much time passed from the previous Snapshot to the
+ * current one. The platforms and the Player are drawn over the grid at their
+ * interpolated positions. The terminal can only show whole cells, so there
+ * the current Snapshot is drawn.
+ */
+int draw_snapshots(const Snapshot *const previous,
+                   const Snapshot *const current, const double alpha,
+                   SDL_Renderer *renderer);
+
+/**
+ * Returns how many frames per second the screen shows.
+ *
+ * This is the refresh rate of the display of the window, or FPS when there
+ * is no window.
+ */
+int get_refresh_rate(void);
+
+/**
+ * Sorts, merges, and submits the provided RenderCommands to the current
+ * render target.
+ *
+ * Flushing does not clear the buffer, so flushing it again replays the frame.
+ *
+ * Returns the number of draw calls issued.
+ */
+int flush_render_commands(RenderCommandBuffer *const buffer,
+                          SDL_Renderer *renderer);
+
+/**
+ * Returns the RenderCommands of the last frame drawn by draw_game.
+ *
+ * These only cover the Cells that changed in that frame.
+ */
+RenderCommandBuffer *get_frame_render_commands(void);
+
 /**
  * Prints the provided string on the screen starting at (x, y).
  *
@@ -95,13 +145,42 @@ BoundingBox bounding_box_from_screen(void);
  */
 Command read_next_command(void);
 
+/**
+ * Appends all pending Commands to the queue, in the order they were issued.
+ *
+ * COMMAND_QUIT is not queued, so that it cannot be dropped.
+ *
+ * Returns CODE_QUIT if the user quit.
+ */
+Code read_commands(CommandQueue *const queue);
+
+/**
+ * Evaluates whether or not the window is shown and has the keyboard focus.
+ *
+ * The terminal is always considered active.
+ */
+int is_window_active(void);
+
+/**
+ * Blocks until the window is shown and has the keyboard focus again.
+ *
+ * Commands issued meanwhile are discarded.
+ *
+ * Returns CODE_QUIT if the user quit.
+ */
+Code wait_for_active_window(void);
+
 /**
  * Waits for the next command, blocking indefinitely.
+ *
+ * Returns COMMAND_NONE if the window has to be drawn again.
  */
 Command wait_for_next_command(void);
 
 /**
  * Waits for any user input, blocking indefinitely.
+ *
+ * Returns CODE_REDRAW if the window has to be drawn again.
  */
 Code wait_for_input(void);
 
@@ -0,0 +1,30 @@
+#include "game.h"
+#include "io.h"
+#include "menu.h"
+#include "options.h"
+#include "random.h"
+
+#include <stdlib.h>
+
+#include <SDL.h>
+
+int main(int argc, char *argv[]) {
+  int result;
+  SDL_Window *window;
+  SDL_Renderer *renderer;
+  initialize_options(argc, argv);
+  /* Benchmarks use the default seed so that every run is the same. */
+  if (!get_options()->benchmark) {
+    seed_random();
+  }
+  if (initialize(&window, &renderer)) {
+    return EXIT_FAILURE;
+  }
+  if (get_options()->benchmark) {
+    result = run_benchmark(renderer);
+  } else {
+    result = main_menu(renderer);
+  }
+  finalize(&window, &renderer);
+  return result;
+}
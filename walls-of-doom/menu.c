@@ -6,6 +6,8 @@
 #include "game.h"
 #include "io.h"
 #include "logger.h"
+#include "memory.h"
+#include "options.h"
 #include "physics.h"
 #include "platform.h"
 #include "random.h"
@@ -37,7 +39,7 @@ void write_menu(const Menu *const menu, SDL_Renderer *renderer) {
   int x;
   size_t i;
   char buffer[MAXIMUM_STRING_SIZE];
-  SDL_RenderClear(renderer);
+  clear(renderer);
   x = (COLUMNS - strlen(menu->title)) / 2;
   print(x, y, menu->title, DEFAULT_COLOR, renderer);
   for (i = 0; i < menu->option_count; i++) {
@@ -50,7 +52,7 @@ void write_menu(const Menu *const menu, SDL_Renderer *renderer) {
     y += ENTRY_HEIGHT;
     print(x, y, string, DEFAULT_COLOR, renderer);
   }
-  SDL_RenderPresent(renderer);
+  present(renderer);
 }
 
 /**
@@ -59,7 +61,8 @@ void write_menu(const Menu *const menu, SDL_Renderer *renderer) {
 int game(SDL_Renderer *renderer) {
   char name[MAXIMUM_PLAYER_NAME_SIZE];
   Player player;
-  Platform platforms[PLATFORM_COUNT];
+  const int platform_count = get_options()->platform_count;
+  Platform *platforms;
   BoundingBox box;
   Game game;
 
@@ -71,16 +74,28 @@ int game(SDL_Renderer *renderer) {
 
   box = bounding_box_from_screen();
 
-  generate_platforms(platforms, PLATFORM_COUNT);
+  platforms = resize_memory(NULL, platform_count * sizeof(Platform));
+  generate_platforms(platforms, platform_count);
 
-  game = create_game(&player, platforms, PLATFORM_COUNT, &box);
+  game = create_game(&player, platforms, platform_count, &box,
+                     get_options()->tick_rate);
+  platforms = resize_memory(platforms, 0);
 
   run_game(&game, renderer);
+  destroy_game(&game);
   return 0;
 }
 
+/**
+ * Runs the main menu until the user quits.
+ *
+ * The menu blocks until there is input and is only drawn again when the
+ * selection changes, when a screen it opened returns, or when the window
+ * needs it.
+ */
 int main_menu(SDL_Renderer *renderer) {
   int should_quit = 0;
+  int should_draw = 1;
   Code code;
   Menu menu;
   char title[MAXIMUM_STRING_SIZE];
@@ -93,21 +108,29 @@ int main_menu(SDL_Renderer *renderer) {
   menu.selected_option = 0;
 
   while (!should_quit) {
-    write_menu(&menu, renderer);
+    if (should_draw) {
+      write_menu(&menu, renderer);
+    }
     command = wait_for_next_command();
+    /* COMMAND_NONE means that the window has to be drawn again. */
+    should_draw = command == COMMAND_NONE;
     if (command == COMMAND_UP) {
+      should_draw = 1;
       if (menu.selected_option > 0) {
         menu.selected_option--;
       } else {
         menu.selected_option = menu.option_count - 1;
       }
     } else if (command == COMMAND_DOWN) {
+      should_draw = 1;
       if (menu.selected_option + 1 < menu.option_count) {
         menu.selected_option++;
       } else {
         menu.selected_option = 0;
       }
     } else if (command == COMMAND_ENTER || command == COMMAND_CENTER) {
+      /* Every option but Quit draws over the menu. */
+      should_draw = 1;
       if (menu.selected_option == 0) {
         game(renderer);
       } else if (menu.selected_option == 1) {
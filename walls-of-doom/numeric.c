@@ -51,3 +51,24 @@ int max(const int a, const int b) {
     return b;
   }
 }
+
+/**
+ * Returns the index of the lowest set bit of the provided value, or -1 if no
+ * bit is set.
+ */
+int find_first_set(const uint64_t value) {
+#ifdef __GNUC__
+  if (value == 0) {
+    return -1;
+  }
+  return __builtin_ctzll(value);
+#else
+  int index;
+  for (index = 0; index < 64; index++) {
+    if ((value >> index) & 1) {
+      return index;
+    }
+  }
+  return -1;
+#endif
+}
@@ -1,6 +1,8 @@
 #ifndef NUMERIC_H
 #define NUMERIC_H
 
+#include <stdint.h>
+
 /**
  * Normalizes a scalar by returning either -1, 0 or 1 if this scalar is
  * negative, zero, or positive, respectively.
@@ -22,4 +24,10 @@ int min(const int a, const int b);
  */
 int max(const int a, const int b);
 
+/**
+ * Returns the index of the lowest set bit of the provided value, or -1 if no
+ * bit is set.
+ */
+int find_first_set(const uint64_t value);
+
 #endif
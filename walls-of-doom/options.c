@@ -0,0 +1,108 @@
+#include "options.h"
+
+#include "constants.h"
+#include "logger.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADLESS_VARIABLE "WALLS_OF_DOOM_HEADLESS"
+#define TERMINAL_VARIABLE "WALLS_OF_DOOM_TERMINAL"
+#define VSYNC_VARIABLE "WALLS_OF_DOOM_VSYNC"
+
+#define CAPTURE_PREFIX "--capture="
+#define TICK_RATE_PREFIX "--tick-rate="
+#define PLATFORMS_PREFIX "--platforms="
+
+#define MINIMUM_TICK_RATE 1
+#define MAXIMUM_TICK_RATE 1000
+
+#define MINIMUM_PLATFORM_COUNT 1
+#define MAXIMUM_PLATFORM_COUNT 65536
+
+static Options options = {0, 0, 0, 0, NULL, FPS, PLATFORM_COUNT};
+
+/**
+ * Evaluates whether or not an environment variable is set to a value which
+ * enables an option.
+ *
+ * Unset variables, empty values, and "0" do not enable options.
+ */
+static int is_enabled_by_environment(const char *name) {
+  const char *value = getenv(name);
+  return value != NULL && value[0] != '\0' && strcmp(value, "0") != 0;
+}
+
+/**
+ * Parses an integer, returning 0 if it is not a number in the provided range.
+ */
+static int parse_integer(const char *string, const long minimum,
+                         const long maximum) {
+  char *end;
+  const long value = strtol(string, &end, 10);
+  if (end == string || *end != '\0') {
+    return 0;
+  }
+  if (value < minimum || value > maximum) {
+    return 0;
+  }
+  return (int)value;
+}
+
+/**
+ * Reads the Options from the command line arguments and the environment.
+ *
+ * Should be called once, before initialize().
+ */
+void initialize_options(int argc, char *argv[]) {
+  char log_buffer[MAXIMUM_STRING_SIZE];
+  int tick_rate;
+  int platform_count;
+  int i;
+  options.headless = is_enabled_by_environment(HEADLESS_VARIABLE);
+  options.terminal = is_enabled_by_environment(TERMINAL_VARIABLE);
+  options.vsync = is_enabled_by_environment(VSYNC_VARIABLE);
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--headless") == 0) {
+      options.headless = 1;
+    } else if (strcmp(argv[i], "--benchmark") == 0) {
+      options.benchmark = 1;
+    } else if (strcmp(argv[i], "--terminal") == 0) {
+      options.terminal = 1;
+    } else if (strcmp(argv[i], "--vsync") == 0) {
+      options.vsync = 1;
+    } else if (strncmp(argv[i], CAPTURE_PREFIX, strlen(CAPTURE_PREFIX)) == 0) {
+      options.capture_path = argv[i] + strlen(CAPTURE_PREFIX);
+    } else if (strncmp(argv[i], TICK_RATE_PREFIX, strlen(TICK_RATE_PREFIX)) ==
+               0) {
+      tick_rate = parse_integer(argv[i] + strlen(TICK_RATE_PREFIX),
+                                MINIMUM_TICK_RATE, MAXIMUM_TICK_RATE);
+      if (tick_rate) {
+        options.tick_rate = tick_rate;
+      } else {
+        sprintf(log_buffer, "Ignored invalid tick rate %.64s", argv[i]);
+        log_message(log_buffer);
+      }
+    } else if (strncmp(argv[i], PLATFORMS_PREFIX, strlen(PLATFORMS_PREFIX)) ==
+               0) {
+      platform_count = parse_integer(argv[i] + strlen(PLATFORMS_PREFIX),
+                                     MINIMUM_PLATFORM_COUNT,
+                                     MAXIMUM_PLATFORM_COUNT);
+      if (platform_count) {
+        options.platform_count = platform_count;
+      } else {
+        sprintf(log_buffer, "Ignored invalid platform count %.64s", argv[i]);
+        log_message(log_buffer);
+      }
+    } else {
+      sprintf(log_buffer, "Ignored unknown option %.64s", argv[i]);
+      log_message(log_buffer);
+    }
+  }
+}
+
+/**
+ * Returns the Options the game was started with.
+ */
+const Options *get_options(void) { return &options; }
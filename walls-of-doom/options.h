@@ -0,0 +1,72 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+/**
+ * The Options the game was started with.
+ *
+ * Options are read from the command line and from the environment.
+ */
+typedef struct Options {
+  /**
+   * Whether or not to render to an offscreen surface, without a display.
+   *
+   * Enabled by --headless or by setting WALLS_OF_DOOM_HEADLESS.
+   */
+  int headless;
+
+  /**
+   * Whether or not to run a benchmark game instead of the main menu.
+   *
+   * Enabled by --benchmark.
+   */
+  int benchmark;
+
+  /**
+   * Whether or not to draw to the terminal with ANSI escape sequences.
+   *
+   * Enabled by --terminal or by setting WALLS_OF_DOOM_TERMINAL.
+   */
+  int terminal;
+
+  /**
+   * Whether or not presents wait for the vertical blank of the display.
+   *
+   * Enabled by --vsync or by setting WALLS_OF_DOOM_VSYNC.
+   */
+  int vsync;
+
+  /**
+   * The path of the Y4M video frames are captured to, or NULL.
+   *
+   * Set by --capture=PATH.
+   */
+  const char *capture_path;
+
+  /**
+   * How many frames per second games are simulated at.
+   *
+   * Set by --tick-rate=N. Defaults to FPS.
+   */
+  int tick_rate;
+
+  /**
+   * How many Platforms games are played with.
+   *
+   * Set by --platforms=N. Defaults to PLATFORM_COUNT.
+   */
+  int platform_count;
+} Options;
+
+/**
+ * Reads the Options from the command line arguments and the environment.
+ *
+ * Should be called once, before initialize().
+ */
+void initialize_options(int argc, char *argv[]);
+
+/**
+ * Returns the Options the game was started with.
+ */
+const Options *get_options(void);
+
+#endif
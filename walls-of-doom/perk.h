@@ -1,13 +1,12 @@
 #ifndef PERK_H
 #define PERK_H
 
+/*
+ * Games convert these durations to frames using their tick rate.
+ */
 #define PERK_INTERVAL_IN_SECONDS 30
-#define PERK_INTERVAL_IN_FRAMES PERK_INTERVAL_IN_SECONDS *FPS
-
 #define PERK_SCREEN_DURATION_IN_SECONDS 15
 #define PERK_PLAYER_DURATION_IN_SECONDS 10
-#define PERK_SCREEN_DURATION_IN_FRAMES PERK_SCREEN_DURATION_IN_SECONDS *FPS
-#define PERK_PLAYER_DURATION_IN_FRAMES PERK_PLAYER_DURATION_IN_SECONDS *FPS
 
 typedef enum Perk {
   PERK_POWER_INVINCIBILITY,
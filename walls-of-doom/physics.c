@@ -1,11 +1,13 @@
 #include "physics.h"
 #include "constants.h"
 #include "logger.h"
+#include "numeric.h"
 #include "random.h"
 
 #include <stdio.h>
+#include <string.h>
 
-static void reposition(Game *const game, Platform *const platform);
+static void reposition(Game *const game, const int index);
 
 /**
  * Evaluates whether or not a Platform is completely outside of a BoundingBox.
@@ -14,16 +16,16 @@ static void reposition(Game *const game, Platform *const platform);
  * Returns 1 if the platform is to the left or to the right of the bounding box.
  * Returns 2 if the platform is above or below the bounding box.
  */
-int is_out_of_bounding_box(Platform *const platform,
-                           const BoundingBox *const box);
+int is_out_of_bounding_box(const PlatformStore *const platforms,
+                           const int index, const BoundingBox *const box);
 
 /**
  * Evaluates whether or not a point is within a Platform.
  */
 int is_within_platform(const int x, const int y,
-                       const Platform *const platform);
+                       const PlatformStore *const platforms, const int index);
 
-void update_platform(Game *const game, Platform *const platform);
+void update_platform(Game *const game, const int index);
 
 int bounding_box_equals(const BoundingBox *const a,
                         const BoundingBox *const b) {
@@ -35,15 +37,212 @@ int bounding_box_equals(const BoundingBox *const a,
  * Evaluates whether or not a point is within a Platform.
  */
 int is_within_platform(const int x, const int y,
-                       const Platform *const platform) {
-  const int p_min_x = platform->x;
-  const int p_max_x = platform->x + platform->width - 1;
-  const int p_y = platform->y;
+                       const PlatformStore *const platforms, const int index) {
+  const int p_min_x = platforms->x[index];
+  const int p_max_x = platforms->x[index] + platforms->width[index] - 1;
+  const int p_y = platforms->y[index];
   return y == p_y && x >= p_min_x && x <= p_max_x;
 }
 
-int is_over_platform(const int x, const int y, const Platform *const platform) {
-  return is_within_platform(x, y + 1, platform);
+int is_over_platform(const int x, const int y,
+                     const PlatformStore *const platforms, const int index) {
+  return is_within_platform(x, y + 1, platforms, index);
+}
+
+/**
+ * Returns the line of the platform index which holds the provided y.
+ */
+static int get_index_line(const int y) { return max(0, min(y, LINES - 1)); }
+
+static void link_platform(Game *const game, const int index) {
+  const int line = get_index_line(game->platforms.y[index]);
+  game->next_on_line[index] = game->first_on_line[line];
+  game->first_on_line[line] = index;
+  game->free_lines &= ~((uint64_t)1 << line);
+}
+
+static void unlink_platform(Game *const game, const int index) {
+  const int line = get_index_line(game->platforms.y[index]);
+  int *link = &game->first_on_line[line];
+  while (*link != index) {
+    link = &game->next_on_line[*link];
+  }
+  *link = game->next_on_line[index];
+  if (game->first_on_line[line] == -1) {
+    game->free_lines |= (uint64_t)1 << line;
+  }
+}
+
+/**
+ * Returns the bits of a word of the occupancy grid from first to end - 1.
+ */
+static uint64_t get_span_mask(const int first, const int end) {
+  const uint64_t ones = ~(uint64_t)0;
+  uint64_t mask = ones << first;
+  if (end < OCCUPANCY_WORD_SIZE) {
+    mask &= ~(ones << end);
+  }
+  return mask;
+}
+
+/**
+ * Writes the mask of the part of a span which is in the word of the occupancy
+ * grid holding x, and advances x to the next word or to the end of the span.
+ *
+ * Returns the index of the word.
+ */
+static int next_span_word(int *const x, const int end, uint64_t *const mask) {
+  const int word = *x / OCCUPANCY_WORD_SIZE;
+  const int word_start = word * OCCUPANCY_WORD_SIZE;
+  const int word_end = min(end - word_start, OCCUPANCY_WORD_SIZE);
+  *mask = get_span_mask(*x - word_start, word_end);
+  *x = word_start + word_end;
+  return word;
+}
+
+/**
+ * Adds delta to how many Platforms cover a cell, keeping the occupancy grid
+ * up to date. Cells outside of the screen are ignored.
+ */
+static void cover_cell(Game *const game, const int x, const int y,
+                       const int delta) {
+  uint64_t *word;
+  uint64_t bit;
+  if (x < 0 || x >= COLUMNS || y < 0 || y >= LINES) {
+    return;
+  }
+  word = &game->occupancy[y][x / OCCUPANCY_WORD_SIZE];
+  bit = (uint64_t)1 << (x % OCCUPANCY_WORD_SIZE);
+  game->coverage[y][x] += delta;
+  if (game->coverage[y][x] == 0) {
+    *word &= ~bit;
+  } else {
+    *word |= bit;
+  }
+}
+
+/**
+ * Adds delta to how many Platforms cover the cells from x to x + width - 1 of
+ * a line.
+ */
+static void cover_span(Game *const game, const int x, const int y,
+                       const int width, const int delta) {
+  const int end = min(x + width, COLUMNS);
+  int i;
+  if (y < 0 || y >= LINES) {
+    return;
+  }
+  for (i = max(x, 0); i < end; i++) {
+    cover_cell(game, i, y, delta);
+  }
+}
+
+/**
+ * Updates the coverage of the two cells a Platform leaves and enters when it
+ * moves by step, which is -1, 0 or 1, from x.
+ */
+static void cover_step(Game *const game, const int index, const int x,
+                       const int step) {
+  const int y = game->platforms.y[index];
+  const int width = game->platforms.width[index];
+  if (step > 0) {
+    cover_cell(game, x, y, -1);
+    cover_cell(game, x + width, y, 1);
+  } else if (step < 0) {
+    cover_cell(game, x + width - 1, y, -1);
+    cover_cell(game, x - 1, y, 1);
+  }
+}
+
+/**
+ * Builds the index from lines to the Platforms on them and the occupancy grid.
+ */
+void index_platforms(Game *const game) {
+  const PlatformStore *const platforms = &game->platforms;
+  size_t i;
+  for (i = 0; i < LINES; i++) {
+    game->first_on_line[i] = -1;
+  }
+  game->free_lines = ~(uint64_t)0;
+  memset(game->coverage, 0, sizeof(game->coverage));
+  memset(game->occupancy, 0, sizeof(game->occupancy));
+  for (i = 0; i < game->platform_count; i++) {
+    link_platform(game, i);
+    cover_span(game, platforms->x[i], platforms->y[i], platforms->width[i], 1);
+  }
+}
+
+/**
+ * Moves a Platform to the provided position, keeping the index and the
+ * occupancy grid up to date.
+ */
+static void place_platform(Game *const game, const int index, const int x,
+                           const int y) {
+  PlatformStore *const platforms = &game->platforms;
+  const int width = platforms->width[index];
+  cover_span(game, platforms->x[index], platforms->y[index], width, -1);
+  if (get_index_line(y) == get_index_line(platforms->y[index])) {
+    platforms->y[index] = y;
+  } else {
+    unlink_platform(game, index);
+    platforms->y[index] = y;
+    link_platform(game, index);
+  }
+  platforms->x[index] = x;
+  cover_span(game, x, y, width, 1);
+}
+
+/**
+ * Evaluates whether or not a Platform covers the provided cell.
+ *
+ * Cells on the screen are a single bit test.
+ */
+int is_cell_occupied(const Game *const game, const int x, const int y) {
+  if (x < 0 || x >= COLUMNS || y < 0 || y >= LINES) {
+    return find_platform_at(game, x, y) != -1;
+  }
+  return (game->occupancy[y][x / OCCUPANCY_WORD_SIZE] >>
+          (x % OCCUPANCY_WORD_SIZE)) &
+         1;
+}
+
+/**
+ * Evaluates whether or not a Platform covers any of the cells from x to
+ * x + width - 1 of the provided line.
+ *
+ * Cells outside of the screen are not tested.
+ */
+int is_span_occupied(const Game *const game, int x, const int y,
+                     const int width) {
+  const int end = min(x + width, COLUMNS);
+  uint64_t mask;
+  int word;
+  if (y < 0 || y >= LINES) {
+    return 0;
+  }
+  x = max(x, 0);
+  while (x < end) {
+    word = next_span_word(&x, end, &mask);
+    if (game->occupancy[y][word] & mask) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Returns the index of a Platform which contains the provided point, or -1.
+ *
+ * Only the Platforms on the line of the point are tested.
+ */
+int find_platform_at(const Game *const game, const int x, const int y) {
+  int i = game->first_on_line[get_index_line(y)];
+  for (; i != -1; i = game->next_on_line[i]) {
+    if (is_within_platform(x, y, &game->platforms, i)) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 /**
@@ -66,70 +265,178 @@ void shove_player(Game *const game, int x, int y) {
   }
 }
 
+/**
+ * Returns every how many frames an object with the specified nonzero speed
+ * moves at the provided tick rate.
+ */
+static unsigned long get_frame_multiple(const int tick_rate, const int speed) {
+  /* Reasoning for rounding a double. */
+  /* Let the tick rate be 30 and speed = 16, if we perform integer division, */
+  /* we will get one. This would be much faster than a speed of 16 would */
+  /* actually be as ideally the object would be moved at every 1.875 frame. */
+  /* Therefore, it is much better to update it at every other frame than at */
+  /* every frame. This shows that the expected behavior is reached by */
+  /* rounding a precise division rather than by truncating the quotient. */
+  /* Play it safe with floating point errors. */
+  const unsigned long multiple = tick_rate / (double)abs(speed) + 0.5;
+  /* Objects faster than the tick rate move at every frame. */
+  return multiple == 0 ? 1 : multiple;
+}
+
+/**
+ * Computes the countdowns of the movement schedule for the current frame.
+ */
+static void reset_countdowns(Game *const game) {
+  MovementSchedule *const schedule = &game->schedule;
+  int speed;
+  for (speed = 1; speed <= MAXIMUM_SCHEDULED_SPEED; speed++) {
+    schedule->countdown[speed] =
+        (schedule->multiple[speed] - game->frame % schedule->multiple[speed]) %
+        schedule->multiple[speed];
+  }
+  schedule->frame = game->frame;
+}
+
+/**
+ * Builds the movement schedule of the provided Game from its tick rate.
+ */
+void initialize_movement_schedule(Game *const game) {
+  MovementSchedule *const schedule = &game->schedule;
+  int speed;
+  /* Objects with no speed never move, so their entry is never read. */
+  schedule->multiple[0] = 1;
+  for (speed = 1; speed <= MAXIMUM_SCHEDULED_SPEED; speed++) {
+    schedule->multiple[speed] = get_frame_multiple(game->tick_rate, speed);
+  }
+  schedule->tick_rate = game->tick_rate;
+  reset_countdowns(game);
+}
+
+/**
+ * Evaluates whether or not the movement schedule of the provided Game was
+ * built for its tick rate and counted down to its current frame.
+ */
+static int is_schedule_current(const Game *const game) {
+  return game->schedule.tick_rate == game->tick_rate &&
+         game->schedule.frame == game->frame;
+}
+
+/**
+ * Moves the provided Game to its next frame, counting the movement schedule
+ * down.
+ */
+void advance_frame(Game *const game) {
+  MovementSchedule *const schedule = &game->schedule;
+  int speed;
+  game->frame++;
+  if (schedule->tick_rate != game->tick_rate) {
+    initialize_movement_schedule(game);
+    return;
+  }
+  if (schedule->frame + 1 != game->frame) {
+    reset_countdowns(game);
+    return;
+  }
+  for (speed = 1; speed <= MAXIMUM_SCHEDULED_SPEED; speed++) {
+    if (schedule->countdown[speed] == 0) {
+      schedule->countdown[speed] = schedule->multiple[speed];
+    }
+    schedule->countdown[speed]--;
+  }
+  schedule->frame = game->frame;
+}
+
 /**
  * Evaluates whether or not an object with the specified speed should move in
  * the current frame of the provided Game.
  *
  * Speed may be any integer, this function is robust enough to handle
  * nonpositive integers.
+ *
+ * Speeds in the movement schedule are a table lookup, as long as the schedule
+ * was built for the tick rate of the Game and the frame was advanced with
+ * advance_frame. Otherwise, the frame is divided.
  */
 int should_move_at_current_frame(const Game *const game, const int speed) {
-  /* Reasoning for rounding a double. */
-  /* Let FPS = 30 and speed = 16, if we perform integer division, we will get */
-  /* one. This would be much faster than a speed of 16 would actually be as */
-  /* ideally the object would be moved at every 1.875 frame. Therefore, it is */
-  /* much better to update it at every other frame than at every frame. This */
-  /* shows that the expected behavior is reached by rounding a precise */
-  /* division rather than by truncating the quotient. */
-  /* Play it safe with floating point errors. */
-  unsigned long multiple;
+  const int magnitude = abs(speed);
   if (speed == 0 || game->frame == 0) {
     return 0;
-  } else {
-    /* Only divide by abs(speed) after checking that speed != 0. */
-    multiple = FPS / (double)abs(speed) + 0.5;
-    return game->frame % multiple == 0;
   }
+  if (magnitude <= MAXIMUM_SCHEDULED_SPEED && is_schedule_current(game)) {
+    return game->schedule.countdown[magnitude] == 0;
+  }
+  /* Only divide by the speed after checking that it is not zero. */
+  return game->frame % get_frame_multiple(game->tick_rate, speed) == 0;
 }
 
-void move_platform_horizontally(Game *const game, Platform *const platform) {
+void move_platform_horizontally(Game *const game, const int index) {
   Player *const player = game->player;
-  if (should_move_at_current_frame(game, platform->speed_x)) {
-    if (player->y ==
-        platform->y) { /* Fail fast if the platform is not on the same line */
-      if (normalize(platform->speed_x) == 1) {
-        if (player->x == platform->x + platform->width) {
+  PlatformStore *const platforms = &game->platforms;
+  const int speed_x = platforms->speed_x[index];
+  if (should_move_at_current_frame(game, speed_x)) {
+    if (player->y == platforms->y[index]) {
+      /* Fail fast if the platform is not on the same line */
+      if (normalize(speed_x) == 1) {
+        if (player->x == platforms->x[index] + platforms->width[index]) {
           shove_player(game, 1, 0);
         }
-      } else if (normalize(platform->speed_x) == -1) {
-        if (player->x == platform->x - 1) {
+      } else if (normalize(speed_x) == -1) {
+        if (player->x == platforms->x[index] - 1) {
           shove_player(game, -1, 0);
         }
       }
-    } else if (is_over_platform(
-                   player->x, player->y,
-                   platform)) { /* If the player is over the platform */
-      shove_player(game, normalize(platform->speed_x), 0);
+    } else if (is_over_platform(player->x, player->y, platforms, index)) {
+      /* If the player is over the platform */
+      shove_player(game, normalize(speed_x), 0);
     }
-    platform->x += normalize(platform->speed_x);
+    cover_step(game, index, platforms->x[index], normalize(speed_x));
+    platforms->x[index] += normalize(speed_x);
   }
 }
 
-void move_platform_vertically(Game *const game, Platform *const platform) {
+void move_platform_vertically(Game *const game, const int index) {
   Player *const player = game->player;
-  if (should_move_at_current_frame(game, platform->speed_y)) {
-    if (player->x >= platform->x && player->x < platform->x + platform->width) {
-      if (normalize(platform->speed_y) == 1) {
-        if (player->y == platform->y + 1) {
+  PlatformStore *const platforms = &game->platforms;
+  const int x = platforms->x[index];
+  const int y = platforms->y[index];
+  const int speed_y = platforms->speed_y[index];
+  if (should_move_at_current_frame(game, speed_y)) {
+    if (player->x >= x && player->x < x + platforms->width[index]) {
+      if (normalize(speed_y) == 1) {
+        if (player->y == y + 1) {
         }
-      } else if (normalize(platform->speed_y) == -1) {
-        if (player->y == platform->y - 1) {
+      } else if (normalize(speed_y) == -1) {
+        if (player->y == y - 1) {
           shove_player(game, 0, -1);
         }
       }
     }
-    platform->y += normalize(platform->speed_y);
+    place_platform(game, index, x, y + normalize(speed_y));
+  }
+}
+
+/**
+ * Returns the first row of the BoundingBox, counting from the provided one and
+ * wrapping around, with no Platform on it.
+ *
+ * Rows are relative to the top of the box. If every row has a Platform, the
+ * provided row is returned.
+ */
+int find_free_row(const Game *const game, const int row) {
+  const BoundingBox *const box = game->box;
+  const int box_height = box->max_y - box->min_y + 1;
+  const uint64_t ones = ~(uint64_t)0;
+  uint64_t free_rows = game->free_lines >> box->min_y;
+  int free_row;
+  if (box_height < 64) {
+    free_rows &= ~(ones << box_height);
   }
+  /* Look below the provided row first, then wrap around to the top. */
+  free_row = find_first_set(free_rows & (ones << row));
+  if (free_row == -1) {
+    free_row = find_first_set(free_rows);
+  }
+  return free_row == -1 ? row : free_row;
 }
 
 /**
@@ -137,45 +444,30 @@ void move_platform_vertically(Game *const game, Platform *const platform) {
  *
  * This function attempts to place the Platform in an empty row.
  */
-static void reposition(Game *const game, Platform *const platform) {
+static void reposition(Game *const game, const int index) {
   const BoundingBox *const box = game->box;
+  const PlatformStore *const platforms = &game->platforms;
+  const int width = platforms->width[index];
   const int box_height = box->max_y - box->min_y + 1;
   const int random_line = random_integer(box->min_y, box->max_y);
-  int occupied[LINES - 2] = {0};
-  int line = random_line % box_height;
-  int i;
-  /* Build a table of occupied rows. */
-  for (i = 0; i < game->platform_count; i++) {
-    occupied[game->platforms[i].y - box->min_y] = 1;
-  }
-  /* Linearly probe for an empty line. */
-  for (i = 0; i < LINES - 2; i++) {
-    if (line >= 0 && line < LINES - 2) {
-      if (!occupied[line]) {
-        break;
-      }
-    }
-    line = (line + 1) % box_height;
-  }
+  const int line = find_free_row(game, random_line % box_height);
   /* To the right of the box. */
-  if (platform->x > box->max_x) {
+  if (platforms->x[index] > box->max_x) {
     /* The platform should be one tick inside the box. */
-    platform->x = box->min_x - platform->width + 1;
-    platform->y = line + box->min_y;
+    place_platform(game, index, box->min_x - width + 1, line + box->min_y);
     /* To the left of the box. */
-  } else if (platform->x + platform->width < box->min_x) {
+  } else if (platforms->x[index] + width < box->min_x) {
     /* The platform should be one tick inside the box. */
-    platform->x = box->max_x;
-    platform->y = line + box->min_y;
+    place_platform(game, index, box->max_x, line + box->min_y);
     /* Above the box. */
-  } else if (platform->y < box->min_y) {
-    platform->x = random_integer(box->min_x, box->max_x - platform->width);
+  } else if (platforms->y[index] < box->min_y) {
     /* Must work when the player is in the last line */
     /* Create it under the bounding box */
-    platform->y = box->max_y + 1;
+    place_platform(game, index, random_integer(box->min_x, box->max_x - width),
+                   box->max_y + 1);
     /* Use the move function to keep the game in a valid state */
     /* This is done this way to prevent superposition. */
-    move_platform_vertically(game, platform);
+    move_platform_vertically(game, index);
   }
 }
 
@@ -186,32 +478,129 @@ static void reposition(Game *const game, Platform *const platform) {
  * Returns 1 if the platform is to the left or to the right of the bounding box.
  * Returns 2 if the platform is above or below the bounding box.
  */
-int is_out_of_bounding_box(Platform *const platform,
-                           const BoundingBox *const box) {
-  const int min_x = platform->x;
-  const int max_x = platform->x + platform->width;
+int is_out_of_bounding_box(const PlatformStore *const platforms,
+                           const int index, const BoundingBox *const box) {
+  const int min_x = platforms->x[index];
+  const int max_x = platforms->x[index] + platforms->width[index];
   if (max_x < box->min_x || min_x > box->max_x) {
     return 1;
-  } else if (platform->y < box->min_y || platform->y > box->max_y) {
+  } else if (platforms->y[index] < box->min_y ||
+             platforms->y[index] > box->max_y) {
     return 2;
   } else {
     return 0;
   }
 }
 
-void update_platform(Game *const game, Platform *const platform) {
-  move_platform_horizontally(game, platform);
-  move_platform_vertically(game, platform);
-  if (is_out_of_bounding_box(platform, game->box)) {
-    reposition(game, platform);
+void update_platform(Game *const game, const int index) {
+  move_platform_horizontally(game, index);
+  move_platform_vertically(game, index);
+  if (is_out_of_bounding_box(&game->platforms, index, game->box)) {
+    reposition(game, index);
+  }
+}
+
+/**
+ * Returns how far an object with the provided speed moves along its axis in
+ * the current frame, given the steps of the scheduled speeds.
+ */
+static int get_step(const Game *const game, const int *const steps,
+                    const int speed) {
+  if (abs(speed) <= MAXIMUM_SCHEDULED_SPEED) {
+    return steps[speed + MAXIMUM_SCHEDULED_SPEED];
+  }
+  if (should_move_at_current_frame(game, speed)) {
+    return normalize(speed);
+  }
+  return 0;
+}
+
+/**
+ * Computes how far each Platform moves horizontally in the current frame.
+ *
+ * The Platforms which move vertically are deferred.
+ */
+static void schedule_platforms(Game *const game) {
+  PlatformStore *const platforms = &game->platforms;
+  int steps[2 * MAXIMUM_SCHEDULED_SPEED + 1];
+  int speed;
+  size_t i;
+  /* Look the step of every scheduled speed up once, rather than once for
+   * every Platform. */
+  for (speed = -MAXIMUM_SCHEDULED_SPEED; speed <= MAXIMUM_SCHEDULED_SPEED;
+       speed++) {
+    steps[speed + MAXIMUM_SCHEDULED_SPEED] = 0;
+    if (should_move_at_current_frame(game, speed)) {
+      steps[speed + MAXIMUM_SCHEDULED_SPEED] = normalize(speed);
+    }
+  }
+  for (i = 0; i < game->platform_count; i++) {
+    platforms->step[i] = get_step(game, steps, platforms->speed_x[i]);
+    platforms->deferred[i] =
+        get_step(game, steps, platforms->speed_y[i]) != 0;
+  }
+}
+
+/**
+ * Moves every Platform which is not deferred horizontally by its step.
+ *
+ * The Platforms on the lines around the Player, which may shove it, and the
+ * Platforms which would end up out of the BoundingBox are deferred instead of
+ * moved. The step of every deferred Platform is set to 0, so that afterwards
+ * the steps are how far each Platform was moved.
+ *
+ * The loop has no branches and walks each array in order, so that compilers
+ * vectorize it.
+ */
+static void move_platforms(PlatformStore *const platforms, const size_t count,
+                           const int player_y, const BoundingBox *const box) {
+  int *const x = platforms->x;
+  const int *const y = platforms->y;
+  const int *const width = platforms->width;
+  int *const step = platforms->step;
+  int *const deferred = platforms->deferred;
+  const int min_x = box->min_x;
+  const int max_x = box->max_x;
+  const int min_y = box->min_y;
+  const int max_y = box->max_y;
+  size_t i;
+  for (i = 0; i < count; i++) {
+    const int moved_x = x[i] + step[i];
+    const int is_near = (y[i] >= player_y - 1) & (y[i] <= player_y + 1);
+    const int is_out = (moved_x + width[i] < min_x) | (moved_x > max_x) |
+                       (y[i] < min_y) | (y[i] > max_y);
+    const int is_deferred = deferred[i] | is_near | is_out;
+    const int moved_step = is_deferred ? 0 : step[i];
+    deferred[i] = is_deferred;
+    step[i] = moved_step;
+    x[i] += moved_step;
   }
 }
 
+/**
+ * Updates all the Platforms of the provided Game.
+ *
+ * Most Platforms only move horizontally, which is done for all of them at
+ * once by move_platforms. The deferred Platforms are then updated one at a
+ * time, as they may shove the Player, move vertically, or be repositioned.
+ */
 void update_platforms(Game *const game) {
   size_t i;
   if (game->player->perk != PERK_POWER_TIME_STOP) {
+    schedule_platforms(game);
+    move_platforms(&game->platforms, game->platform_count, game->player->y,
+                   game->box);
+    /* Count the cells the moved Platforms left and entered. */
+    for (i = 0; i < game->platform_count; i++) {
+      if (game->platforms.step[i] != 0) {
+        cover_step(game, i, game->platforms.x[i] - game->platforms.step[i],
+                   game->platforms.step[i]);
+      }
+    }
     for (i = 0; i < game->platform_count; i++) {
-      update_platform(game, game->platforms + i);
+      if (game->platforms.deferred[i]) {
+        update_platform(game, i);
+      }
     }
   }
 }
@@ -220,21 +609,12 @@ void update_platforms(Game *const game) {
  * Evaluates whether or not the Player is falling. Takes the physics field into
  * account.
  */
-int is_falling(const Player *const player, const Platform *platforms,
-               const size_t platform_count) {
-  size_t i;
+int is_falling(const Game *const game) {
+  const Player *const player = game->player;
   if (!player->physics || player->perk == PERK_POWER_LEVITATION) {
     return 0;
   }
-  for (i = 0; i < platform_count; i++) {
-    if (player->y == platforms[i].y - 1) {
-      if (player->x >= platforms[i].x &&
-          player->x < platforms[i].x + platforms[i].width) {
-        return 0;
-      }
-    }
-  }
-  return 1;
+  return !is_cell_occupied(game, player->x, player->y + 1);
 }
 
 int is_touching_a_wall(const Player *const player,
@@ -276,14 +656,15 @@ void update_perk(Game *const game) {
     /* Current Perk (if any) must end. */
     game->perk = PERK_NONE;
   } else if (game->played_frames ==
-             game->perk_end_frame - PERK_SCREEN_DURATION_IN_FRAMES +
-                 PERK_INTERVAL_IN_FRAMES) {
+             game->perk_end_frame - game->perk_screen_duration_frames +
+                 game->perk_interval_frames) {
     /* If the frame count since the current perk was created is equal to the
      * perk interval, create a new Perk. */
     game->perk = get_random_perk();
     game->perk_x = random_integer(game->box->min_x, game->box->max_x);
     game->perk_y = random_integer(game->box->min_y, game->box->max_y);
-    game->perk_end_frame = game->played_frames + PERK_SCREEN_DURATION_IN_FRAMES;
+    game->perk_end_frame =
+        game->played_frames + game->perk_screen_duration_frames;
   }
 }
 
@@ -292,7 +673,6 @@ void update_perk(Game *const game) {
  * player to occupy.
  */
 int is_valid_move(Game *game, const int x, const int y) {
-  size_t i;
   if (game->player->perk == PERK_POWER_INVINCIBILITY) {
     if ((game->box->min_x - 1 == x || game->box->max_x + 1 == x) ||
         (game->box->min_y - 1 == y || game->box->max_y + 1 == y)) {
@@ -302,10 +682,8 @@ int is_valid_move(Game *game, const int x, const int y) {
   }
   /* If the player is ascending, skip platform collision check. */
   if (game->player->x != x || game->player->y != y + 1) {
-    for (i = 0; i < game->platform_count; i++) {
-      if (is_within_platform(x, y, game->platforms + i)) {
-        return 0;
-      }
+    if (is_cell_occupied(game, x, y)) {
+      return 0;
     }
   }
   return 1;
@@ -352,18 +730,12 @@ int is_jumping(const Player *const player) {
  * bottom border to be treated as a platform.
  */
 int is_standing_on_platform(const Game *const game) {
-  size_t i;
-  if (game->player->perk == PERK_POWER_INVINCIBILITY &&
-      game->player->y == game->box->max_y) {
+  const Player *const player = game->player;
+  if (player->perk == PERK_POWER_INVINCIBILITY &&
+      player->y == game->box->max_y) {
     return 1;
   }
-  for (i = 0; i < game->platform_count; i++) {
-    if (is_over_platform(game->player->x, game->player->y,
-                         game->platforms + i)) {
-      return 1;
-    }
-  }
-  return 0;
+  return is_cell_occupied(game, player->x, player->y + 1);
 }
 
 void process_jump(Game *const game) {
@@ -431,7 +803,7 @@ void update_player_vertical_position(Game *game) {
       move_player(game, 0, -1);
       game->player->remaining_jump_height--;
     }
-  } else if (is_falling(game->player, game->platforms, game->platform_count)) {
+  } else if (is_falling(game)) {
     int falling_speed = PLAYER_FALLING_SPEED;
     if (game->player->perk == PERK_POWER_LOW_GRAVITY) {
       falling_speed /= 2;
@@ -483,7 +855,7 @@ void update_player_perk(Game *game) {
           /* this part would removed it, but this seems more correct. */
           player->perk = PERK_NONE;
         } else {
-          end_frame = game->played_frames + PERK_PLAYER_DURATION_IN_FRAMES;
+          end_frame = game->played_frames + game->perk_player_duration_frames;
           player->perk_end_frame = end_frame;
         }
         write_perk_message(game->message, perk);
@@ -493,8 +865,19 @@ void update_player_perk(Game *game) {
 }
 
 void update_player(Game *game, const Command command) {
+  update_player_with_commands(game, &command, 1);
+}
+
+/**
+ * Updates the player, applying all the provided Commands in order.
+ */
+void update_player_with_commands(Game *game, const Command *commands,
+                                 const size_t command_count) {
+  size_t i;
   update_player_perk(game);
-  process_command(game, command);
+  for (i = 0; i < command_count; i++) {
+    process_command(game, commands[i]);
+  }
   /* This ordering makes the player run horizontally before falling.
    * This seems to be the expected order from an user point-of-view. */
   update_player_horizontal_position(game);
@@ -11,12 +11,72 @@
 
 int bounding_box_equals(const BoundingBox *const a, const BoundingBox *const b);
 
+/**
+ * Builds the movement schedule of the provided Game from its tick rate.
+ */
+void initialize_movement_schedule(Game *const game);
+
+/**
+ * Moves the provided Game to its next frame, counting the movement schedule
+ * down.
+ */
+void advance_frame(Game *const game);
+
+/**
+ * Evaluates whether or not an object with the specified speed should move in
+ * the current frame of the provided Game.
+ */
+int should_move_at_current_frame(const Game *const game, const int speed);
+
+/**
+ * Builds the index from lines to the Platforms on them and the occupancy grid.
+ */
+void index_platforms(Game *const game);
+
+/**
+ * Returns the index of a Platform which contains the provided point, or -1.
+ *
+ * Only the Platforms on the line of the point are tested.
+ */
+int find_platform_at(const Game *const game, const int x, const int y);
+
+/**
+ * Evaluates whether or not a Platform covers the provided cell.
+ *
+ * Cells on the screen are a single bit test.
+ */
+int is_cell_occupied(const Game *const game, const int x, const int y);
+
+/**
+ * Evaluates whether or not a Platform covers any of the cells from x to
+ * x + width - 1 of the provided line.
+ *
+ * Cells outside of the screen are not tested.
+ */
+int is_span_occupied(const Game *const game, const int x, const int y,
+                     const int width);
+
+/**
+ * Returns the first row of the BoundingBox, counting from the provided one and
+ * wrapping around, with no Platform on it.
+ *
+ * Rows are relative to the top of the box. If every row has a Platform, the
+ * provided row is returned.
+ */
+int find_free_row(const Game *const game, const int row);
+
 void update_platforms(Game *game);
 
 void update_perk(Game *game);
 
 void update_player(Game *game, Command command);
 
+/**
+ * Updates the player, applying all the provided Commands in order.
+ */
+void update_player_with_commands(Game *game, const Command *commands,
+                                 size_t command_count);
+
 /**
  * Conceives a bonus perk to the player.
  */
@@ -3,13 +3,18 @@
 #include "constants.h"
 #include "data.h"
 #include "logger.h"
+#include "memory.h"
 #include "random.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #define MINIMUM_WIDTH 4
 #define MAXIMUM_WIDTH 16
 
+/* How many arrays a PlatformStore holds. */
+#define PLATFORM_STORE_ARRAYS 7
+
 /* The platform speed bounds, these are multiplied by the base speed. */
 #define MINIMUM_SPEED 1
 #define MAXIMUM_SPEED 4
@@ -33,3 +38,61 @@ void generate_platforms(Platform *platforms, int count) {
     }
   }
 }
+
+/**
+ * Creates a PlatformStore holding copies of the provided Platforms.
+ */
+PlatformStore create_platform_store(const Platform *platforms,
+                                    const size_t count) {
+  const size_t alignment = PLATFORM_STORE_ALIGNMENT;
+  const size_t ints_per_block = alignment / sizeof(int);
+  /* Pad every array to whole blocks, so that all of them stay aligned. */
+  const size_t blocks = (count + ints_per_block - 1) / ints_per_block;
+  const size_t stride = blocks * ints_per_block;
+  const size_t size = PLATFORM_STORE_ARRAYS * stride * sizeof(int);
+  PlatformStore store;
+  uintptr_t address;
+  int *arrays;
+  size_t i;
+  /* Allocate one more block, so that the arrays can start at its boundary. */
+  store.memory = resize_memory(NULL, size + alignment);
+  address = (uintptr_t)store.memory;
+  arrays = (int *)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+  store.x = arrays;
+  store.y = arrays + stride;
+  store.speed_x = arrays + 2 * stride;
+  store.speed_y = arrays + 3 * stride;
+  store.width = arrays + 4 * stride;
+  store.step = arrays + 5 * stride;
+  store.deferred = arrays + 6 * stride;
+  for (i = 0; i < count; i++) {
+    store.x[i] = platforms[i].x;
+    store.y[i] = platforms[i].y;
+    store.speed_x[i] = platforms[i].speed_x;
+    store.speed_y[i] = platforms[i].speed_y;
+    store.width[i] = platforms[i].width;
+    store.step[i] = 0;
+    store.deferred[i] = 0;
+  }
+  return store;
+}
+
+/**
+ * Frees the memory of the provided PlatformStore.
+ */
+void destroy_platform_store(PlatformStore *const store) {
+  store->memory = resize_memory(store->memory, 0);
+}
+
+/**
+ * Returns a copy of the Platform at the provided index of a PlatformStore.
+ */
+Platform get_platform(const PlatformStore *const store, const size_t index) {
+  Platform platform;
+  platform.x = store->x[index];
+  platform.y = store->y[index];
+  platform.speed_x = store->speed_x[index];
+  platform.speed_y = store->speed_y[index];
+  platform.width = store->width[index];
+  return platform;
+}
@@ -1,6 +1,8 @@
 #ifndef PLATFORM_H
 #define PLATFORM_H
 
+#include <stdlib.h>
+
 typedef struct Platform {
   int x;
   int y;
@@ -9,6 +11,54 @@ typedef struct Platform {
   int width;
 } Platform;
 
+/**
+ * Platforms stored as one array per field, so that loops over the fields of
+ * many Platforms read contiguous memory and can be vectorized.
+ *
+ * Every array starts at a multiple of PLATFORM_STORE_ALIGNMENT bytes.
+ */
+typedef struct PlatformStore {
+  int *x;
+  int *y;
+  int *speed_x;
+  int *speed_y;
+  int *width;
+
+  /**
+   * How far each Platform moves horizontally in the current frame.
+   */
+  int *step;
+
+  /**
+   * Nonzero for the Platforms which are updated one at a time in the current
+   * frame, rather than with the others.
+   */
+  int *deferred;
+
+  /**
+   * The allocation holding all the arrays.
+   */
+  void *memory;
+} PlatformStore;
+
+#define PLATFORM_STORE_ALIGNMENT 64
+
 void generate_platforms(Platform *platforms, int count);
 
+/**
+ * Creates a PlatformStore holding copies of the provided Platforms.
+ */
+PlatformStore create_platform_store(const Platform *platforms,
+                                    const size_t count);
+
+/**
+ * Frees the memory of the provided PlatformStore.
+ */
+void destroy_platform_store(PlatformStore *const store);
+
+/**
+ * Returns a copy of the Platform at the provided index of a PlatformStore.
+ */
+Platform get_platform(const PlatformStore *const store, const size_t index);
+
 #endif
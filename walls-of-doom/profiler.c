@@ -3,6 +3,9 @@
 #include "constants.h"
 #include "data.h"
 #include "memory.h"
+#include "profiler.h"
+
+#include <SDL.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,6 +17,10 @@
 #define OUTPUT_FORMAT "%.2f,%ld,%s\n"
 #define OUTPUT_FORMAT_SIZE 128
 
+#define HISTOGRAM_HEADER "Bucket,Unit,Count,Identifier\n"
+#define HISTOGRAM_FORMAT "%lu-%lu,%s,%lu,%s\n"
+#define LAST_HISTOGRAM_FORMAT "%lu+,%s,%lu,%s\n"
+
 typedef struct ProfilerData {
   char identifier[MAXIMUM_DATA_IDENTIFIER_SIZE];
   Milliseconds sum;
@@ -31,7 +38,33 @@ static size_t table_size = 0;
  */
 static ProfilerData *table = NULL;
 
-Code initialize_profiler(void) { return CODE_OK; }
+typedef struct HistogramData {
+  char identifier[MAXIMUM_DATA_IDENTIFIER_SIZE];
+  /**
+   * The unit of the values of the histogram, as written to the output.
+   */
+  const char *unit;
+  unsigned long counts[HISTOGRAM_BUCKET_COUNT];
+} HistogramData;
+
+/**
+ * A table of histograms, which grows and is searched as the table above.
+ */
+static size_t histogram_table_size = 0;
+static HistogramData *histogram_table = NULL;
+/**
+ * The game and the simulation threads both update the table.
+ */
+static SDL_mutex *table_mutex = NULL;
+
+Code initialize_profiler(void) {
+  table_mutex = SDL_CreateMutex();
+  if (table_mutex == NULL) {
+    log_message("Failed to create the profiler mutex");
+    return CODE_ERROR;
+  }
+  return CODE_OK;
+}
 
 ProfilerData *get_empty_data(const char *identifier) {
   const size_t new_size = (table_size + 1) * sizeof(ProfilerData);
@@ -64,13 +97,99 @@ ProfilerData *get_data(const char *identifier) {
   return table + i - 1;
 }
 
+static HistogramData *get_histogram_data(const char *identifier,
+                                         const char *unit) {
+  const size_t new_size = (histogram_table_size + 1) * sizeof(HistogramData);
+  HistogramData *reallocated_table;
+  HistogramData *data;
+  size_t i;
+  for (i = 0; i < histogram_table_size; i++) {
+    if (strcmp(identifier, histogram_table[i].identifier) == 0) {
+      return histogram_table + i;
+    }
+  }
+  reallocated_table = resize_memory(histogram_table, new_size);
+  if (reallocated_table == NULL) {
+    log_message("Failed to reallocate histogram table");
+    return NULL;
+  }
+  histogram_table = reallocated_table;
+  data = histogram_table + histogram_table_size;
+  histogram_table_size++;
+  copy_string(data->identifier, identifier, MAXIMUM_DATA_IDENTIFIER_SIZE);
+  data->unit = unit;
+  memset(data->counts, 0, sizeof(data->counts));
+  return data;
+}
+
+/**
+ * Returns the index of the histogram bucket which counts the provided value.
+ */
+int get_histogram_bucket(const uint64_t value) {
+  uint64_t limit = 1;
+  int bucket = 0;
+  while (value >= limit && bucket < HISTOGRAM_BUCKET_COUNT - 1) {
+    limit *= 2;
+    bucket++;
+  }
+  return bucket;
+}
+
+/**
+ * Counts a new value in the histogram of an identifier, creating the
+ * histogram with the provided unit if it does not exist.
+ */
+static void count_in_histogram(const char *identifier, const char *unit,
+                               const uint64_t value) {
+  HistogramData *data;
+  SDL_LockMutex(table_mutex);
+  data = get_histogram_data(identifier, unit);
+  if (data != NULL) {
+    data->counts[get_histogram_bucket(value)]++;
+  }
+  SDL_UnlockMutex(table_mutex);
+}
+
+/**
+ * Counts a new millisecond value in the histogram of an identifier.
+ *
+ * Histograms are saved with the other statistics, and should be used when
+ * the tail of the distribution matters more than the mean.
+ */
+void update_profiler_histogram(const char *identifier,
+                               const Milliseconds value) {
+  count_in_histogram(identifier, "ms", value);
+}
+
+/**
+ * Counts a new microsecond value in the histogram of an identifier.
+ *
+ * Should be used for durations which are usually under a millisecond.
+ */
+void update_profiler_microsecond_histogram(const char *identifier,
+                                           const Microseconds value) {
+  count_in_histogram(identifier, "us", value);
+}
+
+/**
+ * Counts a new count, which is not a duration, in the histogram of an
+ * identifier.
+ */
+void update_profiler_count_histogram(const char *identifier,
+                                     const unsigned long value) {
+  count_in_histogram(identifier, "count", value);
+}
+
 /**
  * Updates the statistics about an identifier with a new millisecond count.
  */
 void update_profiler(const char *identifier, const Milliseconds delta) {
-  ProfilerData *data = get_data(identifier);
+  ProfilerData *data;
+  SDL_LockMutex(table_mutex);
+  data = get_data(identifier);
   data->frequency++;
   data->sum += delta;
+  SDL_UnlockMutex(table_mutex);
 }
 
 static double profiler_data_mean(const ProfilerData *const data) {
@@ -120,13 +239,48 @@ void write_statistics(void) {
   }
 }
 
+static void write_histograms(void) {
+  char path[MAXIMUM_PATH_SIZE];
+  const HistogramData *data;
+  unsigned long lower;
+  size_t i;
+  int j;
+  FILE *file;
+  if (histogram_table == NULL) {
+    return;
+  }
+  get_full_path(path, PROFILER_FILE_NAME);
+  file = fopen(path, "a");
+  if (file) {
+    fprintf(file, HISTOGRAM_HEADER);
+    for (i = 0; i < histogram_table_size; i++) {
+      data = histogram_table + i;
+      lower = 0;
+      for (j = 0; j < HISTOGRAM_BUCKET_COUNT - 1; j++) {
+        fprintf(file, HISTOGRAM_FORMAT, lower, (1UL << j) - 1, data->unit,
+                data->counts[j], data->identifier);
+        lower = 1UL << j;
+      }
+      fprintf(file, LAST_HISTOGRAM_FORMAT, lower, data->unit, data->counts[j],
+              data->identifier);
+    }
+    fprintf(file, "\n");
+    fclose(file);
+  }
+}
+
 /**
  * Saves all profiler data to disk and frees the allocated memory.
  */
 Code finalize_profiler(void) {
   write_statistics();
+  write_histograms();
   table = resize_memory(table, 0);
   table_size = 0;
+  histogram_table = resize_memory(histogram_table, 0);
+  histogram_table_size = 0;
+  SDL_DestroyMutex(table_mutex);
+  table_mutex = NULL;
   log_message("Freed the profiler table");
   return CODE_OK;
 }
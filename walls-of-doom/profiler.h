@@ -4,6 +4,8 @@
 #include "clock.h"
 #include "code.h"
 
+#include <stdint.h>
+
 Code initialize_profiler(void);
 
 /**
@@ -11,6 +13,44 @@ Code initialize_profiler(void);
  */
 void update_profiler(const char *identifier, const Milliseconds delta);
 
+/**
+ * How many buckets a histogram has.
+ *
+ * Bucket 0 counts values under 1 unit of the histogram. Each following bucket
+ * counts values up to twice as big as the previous one, and the last bucket
+ * counts all values of at least 32768 units.
+ */
+#define HISTOGRAM_BUCKET_COUNT 16
+
+/**
+ * Returns the index of the histogram bucket which counts the provided value.
+ */
+int get_histogram_bucket(const uint64_t value);
+
+/**
+ * Counts a new millisecond value in the histogram of an identifier.
+ *
+ * Histograms are saved with the other statistics, and should be used when
+ * the tail of the distribution matters more than the mean.
+ */
+void update_profiler_histogram(const char *identifier,
+                               const Milliseconds value);
+
+/**
+ * Counts a new microsecond value in the histogram of an identifier.
+ *
+ * Should be used for durations which are usually under a millisecond.
+ */
+void update_profiler_microsecond_histogram(const char *identifier,
+                                           const Microseconds value);
+
+/**
+ * Counts a new count, which is not a duration, in the histogram of an
+ * identifier.
+ */
+void update_profiler_count_histogram(const char *identifier,
+                                     const unsigned long value);
+
 /**
  * Saves all profiler data to disk and frees the allocated memory.
  */
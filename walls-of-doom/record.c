@@ -195,14 +195,18 @@ Code top_scores(SDL_Renderer *renderer) {
   const int record_width = min(line_width, MAXIMUM_STRING_SIZE - 1);
   const size_t record_count = read_records(records, MAXIMUM_DISPLAYED_RECORDS);
   size_t i;
+  Code code = CODE_REDRAW;
   if (COLUMNS < 16) {
     return CODE_ERROR;
   }
-  clear(renderer);
-  for (i = 0; i < record_count && i < line_count; i++) {
-    record_to_string(records + i, line, record_width);
-    print_centered(PADDING + i, line, DEFAULT_COLOR, renderer);
+  while (code == CODE_REDRAW) {
+    clear(renderer);
+    for (i = 0; i < record_count && i < line_count; i++) {
+      record_to_string(records + i, line, record_width);
+      print_centered(PADDING + i, line, DEFAULT_COLOR, renderer);
+    }
+    present(renderer);
+    code = wait_for_input();
   }
-  present(renderer);
-  return wait_for_input();
+  return code;
 }
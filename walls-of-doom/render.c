@@ -0,0 +1,141 @@
+#include "render.h"
+
+#include "code.h"
+#include "color.h"
+
+#include <stdlib.h>
+
+void clear_render_commands(RenderCommandBuffer *const buffer) {
+  buffer->count = 0;
+}
+
+static Code append_render_command(RenderCommandBuffer *const buffer,
+                                  const RenderCommand command) {
+  if (buffer->count == MAXIMUM_RENDER_COMMAND_COUNT) {
+    return CODE_ERROR;
+  }
+  buffer->commands[buffer->count] = command;
+  buffer->count++;
+  return CODE_OK;
+}
+
+/**
+ * Appends a command which fills width Cells starting at (x, y).
+ *
+ * Returns CODE_ERROR if the buffer is full.
+ */
+Code append_fill_command(RenderCommandBuffer *const buffer, const int x,
+                         const int y, const int width,
+                         const ColorPair color_pair) {
+  RenderCommand command;
+  command.kind = RENDER_COMMAND_FILL;
+  command.x = x;
+  command.y = y;
+  command.w = width;
+  command.h = 1;
+  command.glyph = 0;
+  command.color_pair = color_pair;
+  return append_render_command(buffer, command);
+}
+
+/**
+ * Appends a command which draws the glyph with the provided index at (x, y).
+ *
+ * Returns CODE_ERROR if the buffer is full.
+ */
+Code append_glyph_command(RenderCommandBuffer *const buffer, const int x,
+                          const int y, const int glyph,
+                          const ColorPair color_pair) {
+  RenderCommand command;
+  command.kind = RENDER_COMMAND_GLYPH;
+  command.x = x;
+  command.y = y;
+  command.w = 1;
+  command.h = 1;
+  command.glyph = glyph;
+  command.color_pair = color_pair;
+  return append_render_command(buffer, command);
+}
+
+static int compare_integers(const int a, const int b) {
+  return a < b ? -1 : a == b ? 0 : 1;
+}
+
+static int compare_colors(const Color a, const Color b) {
+  if (a.r != b.r) {
+    return compare_integers(a.r, b.r);
+  }
+  if (a.g != b.g) {
+    return compare_integers(a.g, b.g);
+  }
+  if (a.b != b.b) {
+    return compare_integers(a.b, b.b);
+  }
+  return compare_integers(a.a, b.a);
+}
+
+/**
+ * Orders commands by kind, then by the color they are drawn with, then by
+ * position.
+ */
+static int compare_render_commands(const void *pointer_a,
+                                   const void *pointer_b) {
+  const RenderCommand *a = (const RenderCommand *)pointer_a;
+  const RenderCommand *b = (const RenderCommand *)pointer_b;
+  int result = compare_integers(a->kind, b->kind);
+  if (result == 0) {
+    if (a->kind == RENDER_COMMAND_FILL) {
+      result = compare_colors(a->color_pair.background,
+                              b->color_pair.background);
+    } else {
+      result = compare_colors(a->color_pair.foreground,
+                              b->color_pair.foreground);
+    }
+  }
+  if (result == 0) {
+    result = compare_integers(a->y, b->y);
+  }
+  if (result == 0) {
+    result = compare_integers(a->x, b->x);
+  }
+  return result;
+}
+
+static int can_merge(const RenderCommand *const a,
+                     const RenderCommand *const b) {
+  if (a->kind != RENDER_COMMAND_FILL || b->kind != RENDER_COMMAND_FILL) {
+    return 0;
+  }
+  if (!color_equals(a->color_pair.background, b->color_pair.background)) {
+    return 0;
+  }
+  return a->y == b->y && a->h == b->h && a->x + a->w == b->x;
+}
+
+/**
+ * Sorts the commands so that commands which share a color are adjacent, fills
+ * before glyphs, and then merges horizontally adjacent fills of the same color
+ * into a single command.
+ *
+ * Glyphs are only drawn over fills, and neither fills nor glyphs overlap each
+ * other, so this does not change the result.
+ */
+void sort_and_merge_render_commands(RenderCommandBuffer *const buffer) {
+  RenderCommand *commands = buffer->commands;
+  size_t merged = 0;
+  size_t i;
+  if (buffer->count == 0) {
+    return;
+  }
+  qsort(commands, buffer->count, sizeof(RenderCommand),
+        compare_render_commands);
+  for (i = 1; i < buffer->count; i++) {
+    if (can_merge(commands + merged, commands + i)) {
+      commands[merged].w += commands[i].w;
+    } else {
+      merged++;
+      commands[merged] = commands[i];
+    }
+  }
+  buffer->count = merged + 1;
+}
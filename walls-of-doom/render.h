@@ -0,0 +1,77 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "code.h"
+#include "color.h"
+#include "constants.h"
+
+#include <stdlib.h>
+
+/**
+ * The maximum number of RenderCommands a frame may have.
+ *
+ * This is enough for every Cell of the screen to need a fill and a glyph.
+ */
+#define MAXIMUM_RENDER_COMMAND_COUNT (2 * LINES * COLUMNS)
+
+typedef enum RenderCommandKind {
+  /* Fills the rectangle with the background of the ColorPair. */
+  RENDER_COMMAND_FILL,
+  /* Copies a glyph of the glyph atlas, tinted by the foreground. */
+  RENDER_COMMAND_GLYPH
+} RenderCommandKind;
+
+/**
+ * A RenderCommand is a single drawing operation over a rectangle of Cells.
+ */
+typedef struct RenderCommand {
+  RenderCommandKind kind;
+  int x;
+  int y;
+  int w;
+  int h;
+  /* The index of the glyph in the glyph atlas, only used by glyph commands. */
+  int glyph;
+  ColorPair color_pair;
+} RenderCommand;
+
+/**
+ * A RenderCommandBuffer collects the RenderCommands of a frame so that they
+ * can be sorted, merged, and submitted together.
+ */
+typedef struct RenderCommandBuffer {
+  RenderCommand commands[MAXIMUM_RENDER_COMMAND_COUNT];
+  size_t count;
+} RenderCommandBuffer;
+
+void clear_render_commands(RenderCommandBuffer *const buffer);
+
+/**
+ * Appends a command which fills width Cells starting at (x, y).
+ *
+ * Returns CODE_ERROR if the buffer is full.
+ */
+Code append_fill_command(RenderCommandBuffer *const buffer, const int x,
+                         const int y, const int width,
+                         const ColorPair color_pair);
+
+/**
+ * Appends a command which draws the glyph with the provided index at (x, y).
+ *
+ * Returns CODE_ERROR if the buffer is full.
+ */
+Code append_glyph_command(RenderCommandBuffer *const buffer, const int x,
+                          const int y, const int glyph,
+                          const ColorPair color_pair);
+
+/**
+ * Sorts the commands so that commands which share a color are adjacent, fills
+ * before glyphs, and then merges horizontally adjacent fills of the same color
+ * into a single command.
+ *
+ * Glyphs are only drawn over fills, and neither fills nor glyphs overlap each
+ * other, so this does not change the result.
+ */
+void sort_and_merge_render_commands(RenderCommandBuffer *const buffer);
+
+#endif
@@ -3,7 +3,8 @@
  *
  * As we compile with the "-ansi" option, we need to enable it.
  *
- * This is done by defining the _DEFAULT_SOURCE macro.
+ * This is done by defining the _DEFAULT_SOURCE macro, which also enables
+ * clock_nanosleep().
  *
  * There is no simple alternative solution to this problem.
  */
@@ -11,11 +12,41 @@
 
 #include "rest.h"
 
+#include "clock.h"
 #include "logger.h"
 
+#include <SDL.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
 #include <unistd.h>
 
-#define MICROSECONDS_IN_ONE_SECOND 1000000L
+#define NANOSECONDS_IN_ONE_SECOND 1000000000L
+
+/**
+ * How long before a deadline, in microseconds, rest_until starts spinning,
+ * before it has measured any oversleeping.
+ */
+#define INITIAL_SPIN_THRESHOLD 200
+
+/**
+ * How much longer than the measured oversleeping the spin threshold is.
+ */
+#define SPIN_MARGIN 50
+
+/**
+ * How fast the spin threshold falls when sleeping gets more precise. Each
+ * measurement moves it down by this fraction of the difference.
+ */
+#define SPIN_THRESHOLD_DECAY 16
+
+/**
+ * How long before a deadline rest_until stops sleeping and starts spinning.
+ *
+ * Both the game thread and the simulation thread rest, so this is atomic.
+ */
+static SDL_atomic_t spin_threshold = {INITIAL_SPIN_THRESHOLD};
 
 /**
  * Rests for the specified number of seconds.
@@ -38,3 +69,78 @@ void rest_for_second_fraction(int fps) {
   }
   rest_for_microseconds(MICROSECONDS_IN_ONE_SECOND / fps);
 }
+
+/**
+ * Sleeps for the specified number of microseconds.
+ *
+ * The end of the sleep is computed once and slept until with an absolute
+ * deadline, so that signals interrupting the sleep do not extend it.
+ */
+static void sleep_for_microseconds(const Microseconds microseconds) {
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(TIMER_ABSTIME)
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  end.tv_sec += microseconds / MICROSECONDS_IN_ONE_SECOND;
+  end.tv_nsec += (microseconds % MICROSECONDS_IN_ONE_SECOND) * 1000;
+  if (end.tv_nsec >= NANOSECONDS_IN_ONE_SECOND) {
+    end.tv_sec++;
+    end.tv_nsec -= NANOSECONDS_IN_ONE_SECOND;
+  }
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL) == EINTR) {
+  }
+#else
+  rest_for_microseconds(microseconds);
+#endif
+}
+
+/**
+ * Returns how long before a deadline, in microseconds, rest_until starts
+ * spinning.
+ */
+int get_spin_threshold(void) { return SDL_AtomicGet(&spin_threshold); }
+
+/**
+ * Moves the spin threshold towards the provided oversleeping plus a margin,
+ * within the spin threshold bounds.
+ *
+ * The threshold rises at once, because oversleeping makes the deadline be
+ * missed, and falls slowly.
+ */
+void adapt_spin_threshold(const Microseconds oversleeping) {
+  const int current = SDL_AtomicGet(&spin_threshold);
+  int target = MAXIMUM_SPIN_THRESHOLD;
+  if (oversleeping + SPIN_MARGIN < MAXIMUM_SPIN_THRESHOLD) {
+    target = (int)oversleeping + SPIN_MARGIN;
+  }
+  if (target < MINIMUM_SPIN_THRESHOLD) {
+    target = MINIMUM_SPIN_THRESHOLD;
+  }
+  if (target < current) {
+    target = current - (current - target) / SPIN_THRESHOLD_DECAY;
+  }
+  SDL_AtomicSet(&spin_threshold, target);
+}
+
+/**
+ * Rests until get_microseconds() reaches the provided deadline.
+ *
+ * Sleeps until shortly before the deadline and then spins, yielding the
+ * processor between reads of the clock. How early the spinning starts adapts
+ * to how much sleeping is measured to overshoot.
+ *
+ * Returns immediately if the deadline has already passed.
+ */
+void rest_until(Microseconds deadline) {
+  const Microseconds threshold = SDL_AtomicGet(&spin_threshold);
+  const Microseconds wake_up = deadline - threshold;
+  Microseconds now = get_microseconds();
+  if (deadline > now + threshold) {
+    sleep_for_microseconds(wake_up - now);
+    now = get_microseconds();
+    adapt_spin_threshold(now > wake_up ? now - wake_up : 0);
+  }
+  while (now < deadline) {
+    sched_yield();
+    now = get_microseconds();
+  }
+}
@@ -1,8 +1,20 @@
 #ifndef REST_H
 #define REST_H
 
+#include "clock.h"
+
 #include <stdint.h>
 
+/**
+ * The bounds, in microseconds, of how long before a deadline rest_until
+ * starts spinning.
+ *
+ * Sleeping which overshoots by more than the maximum is not compensated for,
+ * so that a thread never spins for long without yielding the processor.
+ */
+#define MINIMUM_SPIN_THRESHOLD 50
+#define MAXIMUM_SPIN_THRESHOLD 300
+
 /**
  * Rests for the specified number of seconds.
  */
@@ -18,4 +30,30 @@ void rest_for_microseconds(uint64_t microseconds);
  */
 void rest_for_second_fraction(int fps);
 
+/**
+ * Returns how long before a deadline, in microseconds, rest_until starts
+ * spinning.
+ */
+int get_spin_threshold(void);
+
+/**
+ * Moves the spin threshold towards the provided oversleeping plus a margin,
+ * within the spin threshold bounds.
+ *
+ * The threshold rises at once, because oversleeping makes the deadline be
+ * missed, and falls slowly.
+ */
+void adapt_spin_threshold(const Microseconds oversleeping);
+
+/**
+ * Rests until get_microseconds() reaches the provided deadline.
+ *
+ * Sleeps until shortly before the deadline and then spins, yielding the
+ * processor between reads of the clock. How early the spinning starts adapts
+ * to how much sleeping is measured to overshoot.
+ *
+ * Returns immediately if the deadline has already passed.
+ */
+void rest_until(Microseconds deadline);
+
 #endif
@@ -0,0 +1,151 @@
+#include "snapshot.h"
+
+#include "constants.h"
+#include "game.h"
+#include "memory.h"
+#include "text.h"
+
+#include <SDL.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define STATE_INDEX_MASK 3
+#define FRESH_STATE_BIT 4
+
+/**
+ * Initializes the provided Snapshot without any Platforms.
+ */
+void initialize_snapshot(Snapshot *const snapshot) {
+  snapshot->platforms = NULL;
+  snapshot->platform_count = 0;
+  snapshot->platform_capacity = 0;
+}
+
+/**
+ * Frees the Platforms of the provided Snapshot.
+ */
+void destroy_snapshot(Snapshot *const snapshot) {
+  snapshot->platforms = resize_memory(snapshot->platforms, 0);
+  snapshot->platform_count = 0;
+  snapshot->platform_capacity = 0;
+}
+
+/**
+ * Makes room for the provided number of Platforms in the provided Snapshot.
+ *
+ * As the number of Platforms of a Game does not change, this only allocates
+ * for the first Snapshot of each Game.
+ */
+static void reserve_platforms(Snapshot *const snapshot, const size_t count) {
+  if (count > snapshot->platform_capacity) {
+    snapshot->platforms =
+        resize_memory(snapshot->platforms, count * sizeof(Platform));
+    snapshot->platform_capacity = count;
+  }
+}
+
+/**
+ * Copies the source Snapshot to the destination Snapshot, growing the
+ * Platforms of the destination if needed.
+ */
+void copy_snapshot(Snapshot *const destination, const Snapshot *const source) {
+  Platform *platforms;
+  size_t platform_capacity;
+  reserve_platforms(destination, source->platform_count);
+  platforms = destination->platforms;
+  platform_capacity = destination->platform_capacity;
+  *destination = *source;
+  destination->platforms = platforms;
+  destination->platform_capacity = platform_capacity;
+  if (source->platform_count > 0) {
+    memcpy(platforms, source->platforms,
+           source->platform_count * sizeof(Platform));
+  }
+}
+
+/**
+ * Copies the current state of the provided Game to the provided Snapshot,
+ * growing the Platforms of the Snapshot if needed.
+ */
+void take_snapshot(const Game *const game, Snapshot *const snapshot) {
+  size_t i;
+  reserve_platforms(snapshot, game->platform_count);
+  snapshot->frame = game->frame;
+  snapshot->player = *game->player;
+  for (i = 0; i < game->platform_count; i++) {
+    snapshot->platforms[i] = get_platform(&game->platforms, i);
+  }
+  snapshot->platform_count = game->platform_count;
+  snapshot->perk = game->perk;
+  snapshot->perk_x = game->perk_x;
+  snapshot->perk_y = game->perk_y;
+  snapshot->box = *game->box;
+  copy_string(snapshot->message, game->message, MAXIMUM_STRING_SIZE);
+}
+
+/**
+ * Interpolates between two coordinates of an object, with alpha in [0, 1].
+ *
+ * Objects which moved more than one cell were repositioned, not moved, so
+ * they are not interpolated and the current coordinate is returned.
+ */
+double interpolate_coordinate(const int previous, const int current,
+                              const double alpha) {
+  if (abs(current - previous) > 1) {
+    return current;
+  }
+  return previous + (current - previous) * alpha;
+}
+
+void initialize_snapshot_exchange(SnapshotExchange *const exchange) {
+  int i;
+  for (i = 0; i < 3; i++) {
+    initialize_snapshot(&exchange->states[i].previous);
+    initialize_snapshot(&exchange->states[i].current);
+  }
+  exchange->back = 0;
+  SDL_AtomicSet(&exchange->middle, 1);
+  exchange->front = 2;
+}
+
+/**
+ * Frees the Snapshots of the states of the provided SnapshotExchange.
+ */
+void destroy_snapshot_exchange(SnapshotExchange *const exchange) {
+  int i;
+  for (i = 0; i < 3; i++) {
+    destroy_snapshot(&exchange->states[i].previous);
+    destroy_snapshot(&exchange->states[i].current);
+  }
+}
+
+/**
+ * Returns the state the writer should fill before publishing it.
+ */
+SimulationState *get_back_state(SnapshotExchange *const exchange) {
+  return exchange->states + exchange->back;
+}
+
+/**
+ * Makes the back state the latest state, and gets a new back state.
+ */
+void publish_back_state(SnapshotExchange *const exchange) {
+  const int published = exchange->back | FRESH_STATE_BIT;
+  /* SDL_AtomicSet is a full barrier, so the state is written before this. */
+  exchange->back = SDL_AtomicSet(&exchange->middle, published) &
+                   STATE_INDEX_MASK;
+}
+
+/**
+ * Returns the latest published state.
+ *
+ * The returned state is not modified until the next call.
+ */
+const SimulationState *get_latest_state(SnapshotExchange *const exchange) {
+  if (SDL_AtomicGet(&exchange->middle) & FRESH_STATE_BIT) {
+    exchange->front = SDL_AtomicSet(&exchange->middle, exchange->front) &
+                      STATE_INDEX_MASK;
+  }
+  return exchange->states + exchange->front;
+}
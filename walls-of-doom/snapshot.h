@@ -0,0 +1,126 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "box.h"
+#include "clock.h"
+#include "constants.h"
+#include "game.h"
+#include "perk.h"
+#include "platform.h"
+#include "player.h"
+
+#include <SDL.h>
+
+#include <stdlib.h>
+
+/**
+ * A Snapshot is a copy of everything needed to draw a Game at one frame.
+ *
+ * Drawing from Snapshots instead of from the Game allows drawing positions
+ * between two simulation steps.
+ */
+typedef struct Snapshot {
+  unsigned long frame;
+  Player player;
+  /* Grown as needed to hold every Platform of the Game. */
+  Platform *platforms;
+  size_t platform_count;
+  size_t platform_capacity;
+  Perk perk;
+  int perk_x;
+  int perk_y;
+  BoundingBox box;
+  char message[MAXIMUM_STRING_SIZE];
+} Snapshot;
+
+/**
+ * The two most recent Snapshots of a running Game and when the next one is
+ * due, which is everything needed to draw between them.
+ */
+typedef struct SimulationState {
+  Snapshot previous;
+  Snapshot current;
+  /* When the step after current is due, on the get_microseconds() clock. */
+  Microseconds deadline;
+  /* Whether or not a Command was applied since the previous state. */
+  int has_input;
+  /* When the first of these Commands was issued. */
+  Milliseconds input_timestamp;
+} SimulationState;
+
+/**
+ * A lock-free triple buffer of SimulationStates, with a single writer and a
+ * single reader.
+ *
+ * The writer fills the back state and publishes it by swapping it with the
+ * middle state. The reader swaps the front state with the middle state if
+ * the middle state was published since its last swap. Neither ever waits for
+ * the other, and the reader always gets the latest published state.
+ */
+typedef struct SnapshotExchange {
+  SimulationState states[3];
+  /* The index of the middle state, with a flag set if it was published since
+   * the reader last took it. */
+  SDL_atomic_t middle;
+  /* Only used by the writer. */
+  int back;
+  /* Only used by the reader. */
+  int front;
+} SnapshotExchange;
+
+/**
+ * Initializes the provided Snapshot without any Platforms.
+ */
+void initialize_snapshot(Snapshot *const snapshot);
+
+/**
+ * Frees the Platforms of the provided Snapshot.
+ */
+void destroy_snapshot(Snapshot *const snapshot);
+
+/**
+ * Copies the source Snapshot to the destination Snapshot, growing the
+ * Platforms of the destination if needed.
+ */
+void copy_snapshot(Snapshot *const destination, const Snapshot *const source);
+
+void initialize_snapshot_exchange(SnapshotExchange *const exchange);
+
+/**
+ * Frees the Snapshots of the states of the provided SnapshotExchange.
+ */
+void destroy_snapshot_exchange(SnapshotExchange *const exchange);
+
+/**
+ * Returns the state the writer should fill before publishing it.
+ */
+SimulationState *get_back_state(SnapshotExchange *const exchange);
+
+/**
+ * Makes the back state the latest state, and gets a new back state.
+ */
+void publish_back_state(SnapshotExchange *const exchange);
+
+/**
+ * Returns the latest published state.
+ *
+ * The returned state is not modified until the next call.
+ */
+const SimulationState *get_latest_state(SnapshotExchange *const exchange);
+
+/**
+ * Copies the current state of the provided Game to the provided Snapshot,
+ * growing the Platforms of the Snapshot if needed.
+ */
+void take_snapshot(const Game *const game, Snapshot *const snapshot);
+
+/**
+ * Interpolates between two coordinates of an object, with alpha in [0, 1].
+ *
+ * Objects which moved more than one cell were repositioned, not moved, so
+ * they are not interpolated and the current coordinate is returned.
+ */
+double interpolate_coordinate(const int previous, const int current,
+                              const double alpha);
+
+#endif
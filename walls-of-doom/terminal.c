@@ -0,0 +1,397 @@
+/*
+ * The terminal backend needs termios and select, which are not part of ISO C.
+ *
+ * This is done by defining the _DEFAULT_SOURCE macro, as in rest.c.
+ */
+#define _DEFAULT_SOURCE
+
+#include "terminal.h"
+
+#include "code.h"
+#include "color.h"
+#include "command.h"
+#include "constants.h"
+#include "grid.h"
+#include "logger.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Enter the alternate screen, hide the cursor, and clear the screen. */
+#define ENTER_SEQUENCE "\033[?1049h\033[?25l\033[2J"
+/* Reset the colors, show the cursor, and leave the alternate screen. */
+#define LEAVE_SEQUENCE "\033[0m\033[?25h\033[?1049l"
+
+/**
+ * Gaps of unchanged Cells up to this width are rewritten instead of skipped,
+ * as this is shorter than moving the cursor.
+ */
+#define MAXIMUM_REWRITTEN_GAP 3
+
+/**
+ * How long, in milliseconds, to wait for the rest of an escape sequence which
+ * arrived split, as happens over slow connections.
+ */
+#define ESCAPE_SEQUENCE_TIMEOUT 50
+
+static struct termios original_attributes;
+static int is_initialized = 0;
+
+/**
+ * What the terminal currently shows.
+ */
+static Grid terminal_grid;
+static int terminal_grid_is_valid = 0;
+
+static char terminal_output[TERMINAL_OUTPUT_SIZE];
+
+/**
+ * Writes all the provided bytes to the standard output.
+ *
+ * Writes interrupted by signals are retried.
+ */
+static Code write_all(const char *bytes, size_t size) {
+  ssize_t written;
+  while (size > 0) {
+    written = write(STDOUT_FILENO, bytes, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      return CODE_ERROR;
+    }
+    bytes += written;
+    size -= written;
+  }
+  return CODE_OK;
+}
+
+/**
+ * Evaluates whether or not the Cells of the row in [begin, end) can be
+ * rewritten as they are, without changing colors.
+ */
+static int can_rewrite_gap(const Cell *row, int begin, const int end,
+                           const ColorPair colors) {
+  if (end - begin > MAXIMUM_REWRITTEN_GAP) {
+    return 0;
+  }
+  for (; begin < end; begin++) {
+    if (!color_pair_equals(row[begin].color_pair, colors)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Makes the terminal raw and switches to the alternate screen.
+ *
+ * Returns CODE_ERROR if the standard input or output is not a terminal.
+ */
+Code initialize_terminal(void) {
+  struct termios attributes;
+  if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+    log_message("The terminal backend requires a terminal");
+    return CODE_ERROR;
+  }
+  if (tcgetattr(STDIN_FILENO, &original_attributes)) {
+    log_message("Failed to get the terminal attributes");
+    return CODE_ERROR;
+  }
+  attributes = original_attributes;
+  /* No echo, no line buffering, no signals, and no input translation. */
+  attributes.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+  attributes.c_iflag &= ~(IXON | ICRNL | INLCR | ISTRIP);
+  /* Reads return immediately, even if there is no input. */
+  attributes.c_cc[VMIN] = 0;
+  attributes.c_cc[VTIME] = 0;
+  if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &attributes)) {
+    log_message("Failed to set the terminal attributes");
+    return CODE_ERROR;
+  }
+  is_initialized = 1;
+  invalidate_terminal_grid();
+  return write_all(ENTER_SEQUENCE, strlen(ENTER_SEQUENCE));
+}
+
+/**
+ * Restores the terminal to the state it had before initialize_terminal.
+ */
+void finalize_terminal(void) {
+  if (is_initialized) {
+    write_all(LEAVE_SEQUENCE, strlen(LEAVE_SEQUENCE));
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &original_attributes);
+    is_initialized = 0;
+  }
+}
+
+/**
+ * Makes the next write to the terminal write every Cell, as if the terminal
+ * showed nothing.
+ */
+void invalidate_terminal_grid(void) { terminal_grid_is_valid = 0; }
+
+/**
+ * Writes to output the bytes which make the terminal show the provided Grid,
+ * and remembers the Grid as what the terminal shows.
+ *
+ * Only the Cells which changed since the last call are written, using as few
+ * cursor movements and color changes as possible. Output must hold at least
+ * TERMINAL_OUTPUT_SIZE bytes.
+ *
+ * Returns how many bytes were written.
+ */
+size_t encode_grid_changes(const Grid *const grid, char *output) {
+  const char *format;
+  ColorPair current_colors;
+  int has_colors = 0;
+  /* Where the cursor is, if known. */
+  int cursor_x = -1;
+  int cursor_y = -1;
+  size_t size = 0;
+  Cell cell;
+  int x;
+  int y;
+  for (y = 0; y < LINES; y++) {
+    for (x = 0; x < COLUMNS; x++) {
+      cell = grid->cells[y][x];
+      if (terminal_grid_is_valid &&
+          cell_equals(cell, terminal_grid.cells[y][x])) {
+        continue;
+      }
+      terminal_grid.cells[y][x] = cell;
+      if (y != cursor_y || x != cursor_x) {
+        if (y == cursor_y && x > cursor_x &&
+            can_rewrite_gap(grid->cells[y], cursor_x, x, current_colors)) {
+          for (; cursor_x < x; cursor_x++) {
+            output[size++] = grid->cells[y][cursor_x].glyph;
+          }
+        } else if (y == cursor_y && x > cursor_x) {
+          /* Moving forward on the same line is shorter. */
+          size += sprintf(output + size, "\033[%dC", x - cursor_x);
+        } else {
+          size += sprintf(output + size, "\033[%d;%dH", y + 1, x + 1);
+        }
+      }
+      if (!has_colors || !color_pair_equals(cell.color_pair, current_colors)) {
+        format = "\033[38;2;%d;%d;%d;48;2;%d;%d;%dm";
+        size += sprintf(output + size, format, cell.color_pair.foreground.r,
+                        cell.color_pair.foreground.g,
+                        cell.color_pair.foreground.b,
+                        cell.color_pair.background.r,
+                        cell.color_pair.background.g,
+                        cell.color_pair.background.b);
+        current_colors = cell.color_pair;
+        has_colors = 1;
+      }
+      output[size++] = cell.glyph;
+      cursor_x = x + 1;
+      cursor_y = y;
+      if (cursor_x == COLUMNS) {
+        /* Terminals differ on where the cursor is after the last column. */
+        cursor_x = -1;
+        cursor_y = -1;
+      }
+    }
+  }
+  terminal_grid_is_valid = 1;
+  return size;
+}
+
+/**
+ * Shows the provided Grid on the terminal.
+ *
+ * Only the Cells which changed since the last call are written, using as few
+ * cursor movements and color changes as possible, with a single write.
+ */
+Code write_grid_to_terminal(const Grid *const grid) {
+  const size_t size = encode_grid_changes(grid, terminal_output);
+  if (size == 0) {
+    return CODE_OK;
+  }
+  return write_all(terminal_output, size);
+}
+
+/**
+ * Returns the next byte of input or TERMINAL_NO_INPUT if there is none.
+ */
+int read_terminal_byte(void) {
+  unsigned char byte;
+  if (read(STDIN_FILENO, &byte, 1) == 1) {
+    return byte;
+  }
+  return TERMINAL_NO_INPUT;
+}
+
+/**
+ * Blocks until there is input to read or the timeout, in milliseconds,
+ * expires. A negative timeout waits indefinitely.
+ *
+ * Returns the result of select.
+ */
+static int wait_for_terminal_input(const int timeout) {
+  struct timeval interval;
+  fd_set descriptors;
+  FD_ZERO(&descriptors);
+  FD_SET(STDIN_FILENO, &descriptors);
+  interval.tv_sec = timeout / 1000;
+  interval.tv_usec = (timeout % 1000) * 1000;
+  return select(STDIN_FILENO + 1, &descriptors, NULL, NULL,
+                timeout < 0 ? NULL : &interval);
+}
+
+/**
+ * Returns the next byte of an escape sequence, waiting briefly for it if it
+ * has not arrived yet, or TERMINAL_NO_INPUT if it does not arrive.
+ */
+static int read_escape_sequence_byte(void) {
+  const int byte = read_terminal_byte();
+  if (byte != TERMINAL_NO_INPUT) {
+    return byte;
+  }
+  if (wait_for_terminal_input(ESCAPE_SEQUENCE_TIMEOUT) <= 0) {
+    return TERMINAL_NO_INPUT;
+  }
+  return read_terminal_byte();
+}
+
+/**
+ * Reads the rest of an escape sequence, after the escape, and returns its
+ * final byte.
+ */
+static int read_escape_sequence(void) {
+  int byte = read_escape_sequence_byte();
+  /* Cursor keys are sent either as CSI or as SS3 sequences. */
+  if (byte != '[' && byte != 'O') {
+    return byte;
+  }
+  do {
+    byte = read_escape_sequence_byte();
+  } while (byte != TERMINAL_NO_INPUT && (byte < '@' || byte > '~'));
+  return byte;
+}
+
+/**
+ * Waits for the next byte of input and returns it.
+ *
+ * Escape sequences are discarded and returned as a single escape.
+ *
+ * A negative timeout, in milliseconds, waits indefinitely.
+ *
+ * Returns TERMINAL_NO_INPUT if the timeout expired.
+ */
+int wait_for_terminal_byte(const int timeout) {
+  int byte;
+  if (wait_for_terminal_input(timeout) <= 0) {
+    return TERMINAL_NO_INPUT;
+  }
+  byte = read_terminal_byte();
+  if (byte == TERMINAL_ESCAPE) {
+    read_escape_sequence();
+  }
+  return byte;
+}
+
+/**
+ * Returns the Command of an arrow key escape sequence, after the escape.
+ */
+static Command command_from_escape_sequence(void) {
+  switch (read_escape_sequence()) {
+  case 'A':
+    return COMMAND_UP;
+  case 'B':
+    return COMMAND_DOWN;
+  case 'C':
+    return COMMAND_RIGHT;
+  case 'D':
+    return COMMAND_LEFT;
+  default:
+    return COMMAND_NONE;
+  }
+}
+
+static Command command_from_byte(const int byte) {
+  if (byte == TERMINAL_ESCAPE) {
+    return command_from_escape_sequence();
+  } else if (byte == TERMINAL_INTERRUPT || byte == 'q') {
+    return COMMAND_QUIT;
+  } else if (byte == '8') {
+    return COMMAND_UP;
+  } else if (byte == '4') {
+    return COMMAND_LEFT;
+  } else if (byte == '5') {
+    return COMMAND_CENTER;
+  } else if (byte == '6') {
+    return COMMAND_RIGHT;
+  } else if (byte == '2') {
+    return COMMAND_DOWN;
+  } else if (byte == ' ') {
+    return COMMAND_JUMP;
+  } else if (byte == '\r' || byte == '\n') {
+    return COMMAND_ENTER;
+  }
+  return COMMAND_NONE;
+}
+
+/**
+ * Reads pending input until it produces a Command different than
+ * COMMAND_NONE and returns it, or returns COMMAND_NONE if there is no input.
+ */
+Command read_next_terminal_command(void) {
+  Command command;
+  int byte;
+  while ((byte = read_terminal_byte()) != TERMINAL_NO_INPUT) {
+    command = command_from_byte(byte);
+    if (command != COMMAND_NONE) {
+      return command;
+    }
+  }
+  return COMMAND_NONE;
+}
+
+/**
+ * Blocks until input produces a Command different than COMMAND_NONE and
+ * returns it.
+ *
+ * Returns COMMAND_QUIT if input can no longer be read.
+ */
+Command wait_for_terminal_command(void) {
+  Command command;
+  int result;
+  int byte;
+  while (1) {
+    result = wait_for_terminal_input(-1);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      return COMMAND_QUIT;
+    }
+    byte = read_terminal_byte();
+    /* Input which is ready but empty means that the terminal was closed. */
+    if (byte == TERMINAL_NO_INPUT) {
+      return COMMAND_QUIT;
+    }
+    command = command_from_byte(byte);
+    if (command != COMMAND_NONE) {
+      return command;
+    }
+  }
+}
+
+/**
+ * Reads all pending input and returns the last Command different than
+ * COMMAND_NONE it produced, or COMMAND_NONE.
+ */
+Command read_terminal_command(void) {
+  Command last_valid_command = COMMAND_NONE;
+  Command current;
+  while ((current = read_next_terminal_command()) != COMMAND_NONE) {
+    last_valid_command = current;
+  }
+  return last_valid_command;
+}
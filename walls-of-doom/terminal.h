@@ -0,0 +1,107 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include "code.h"
+#include "command.h"
+#include "grid.h"
+
+#include <stdlib.h>
+
+/**
+ * The value read_terminal_byte returns when there is no input.
+ */
+#define TERMINAL_NO_INPUT -1
+
+/**
+ * The byte the terminal sends for Control-C when signals are disabled.
+ */
+#define TERMINAL_INTERRUPT 3
+
+#define TERMINAL_ESCAPE 27
+
+/**
+ * The longest sequence written for a Cell is a cursor position, both colors,
+ * and the glyph, which is less than this.
+ */
+#define MAXIMUM_CELL_OUTPUT_SIZE 64
+
+/**
+ * How many bytes encode_grid_changes may write.
+ */
+#define TERMINAL_OUTPUT_SIZE (LINES * COLUMNS * MAXIMUM_CELL_OUTPUT_SIZE)
+
+/**
+ * Makes the terminal raw and switches to the alternate screen.
+ *
+ * Returns CODE_ERROR if the standard input or output is not a terminal.
+ */
+Code initialize_terminal(void);
+
+/**
+ * Restores the terminal to the state it had before initialize_terminal.
+ */
+void finalize_terminal(void);
+
+/**
+ * Makes the next write to the terminal write every Cell, as if the terminal
+ * showed nothing.
+ */
+void invalidate_terminal_grid(void);
+
+/**
+ * Writes to output the bytes which make the terminal show the provided Grid,
+ * and remembers the Grid as what the terminal shows.
+ *
+ * Only the Cells which changed since the last call are written, using as few
+ * cursor movements and color changes as possible. Output must hold at least
+ * TERMINAL_OUTPUT_SIZE bytes.
+ *
+ * Returns how many bytes were written.
+ */
+size_t encode_grid_changes(const Grid *const grid, char *output);
+
+/**
+ * Shows the provided Grid on the terminal.
+ *
+ * Only the Cells which changed since the last call are written, using as few
+ * cursor movements and color changes as possible, with a single write.
+ */
+Code write_grid_to_terminal(const Grid *const grid);
+
+/**
+ * Returns the next byte of input or TERMINAL_NO_INPUT if there is none.
+ */
+int read_terminal_byte(void);
+
+/**
+ * Waits for the next byte of input and returns it.
+ *
+ * Escape sequences are discarded and returned as a single escape.
+ *
+ * A negative timeout, in milliseconds, waits indefinitely.
+ *
+ * Returns TERMINAL_NO_INPUT if the timeout expired.
+ */
+int wait_for_terminal_byte(const int timeout);
+
+/**
+ * Reads pending input until it produces a Command different than
+ * COMMAND_NONE and returns it, or returns COMMAND_NONE if there is no input.
+ */
+Command read_next_terminal_command(void);
+
+/**
+ * Blocks until input produces a Command different than COMMAND_NONE and
+ * returns it.
+ *
+ * Returns COMMAND_QUIT if input can no longer be read.
+ */
+Command wait_for_terminal_command(void);
+
+/**
+ * Reads all pending input and returns the last Command different than
+ * COMMAND_NONE it produced, or COMMAND_NONE.
+ */
+Command read_terminal_command(void);
+
+#endif